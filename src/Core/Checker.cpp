@@ -86,23 +86,31 @@ void Checker::prepare()
 
     checkerCode = Util::readFile(checkerOriginalPath, tr("Read Checker"), log);
     if (checkerCode.isNull())
+    {
+        emit compilationFailed(tr("Failed to read the checker [%1]").arg(checkerOriginalPath));
         return;
+    }
 
     tmpDir = new QTemporaryDir();
     if (!tmpDir->isValid())
     {
         log->error(tr("Checker"), tr("Failed to create temporary directory"));
+        emit compilationFailed(tr("Failed to create temporary directory"));
         return;
     }
 
     checkerTmpPath = tmpDir->filePath("checker.cpp");
-    if (!Util::saveFile(checkerTmpPath, checkerCode, tr("Checker"), false, log))
+    if (!Util::saveFile(checkerTmpPath, checkerCode, tr("Checker"), false, log, false, Util::FileKind::Temp))
+    {
+        emit compilationFailed(tr("Failed to write the checker to [%1]").arg(checkerTmpPath));
         return;
+    }
 
     auto testlib_h = Util::readFile(":/testlib/testlib.h", tr("Read testlib.h"), log);
     if (testlib_h.isNull())
         return;
-    if (!Util::saveFile(tmpDir->filePath("testlib.h"), testlib_h, tr("Save testlib.h"), false, log))
+    if (!Util::saveFile(tmpDir->filePath("testlib.h"), testlib_h, tr("Save testlib.h"), false, log, false,
+                        Util::FileKind::Temp))
         return;
 
     delete compiler;
@@ -125,6 +133,19 @@ void Checker::reqeustCheck(int index, const QString &input, const QString &outpu
         pendingTasks.push_back({index, input, output, expected}); // otherwise push it into the pending tasks list
 }
 
+void Checker::requestInteraction(Runner *runner, const QString &tmpFilePath, const QString &sourceFilePath,
+                                 const QString &lang, const QString &runCommand, const QString &args,
+                                 const QString &input, const QString &expected, int timeLimit)
+{
+    recompileIfChanged();
+    LOG_INFO(BOOL_INFO_OF(compiled));
+    InteractionTask task{runner, tmpFilePath, sourceFilePath, lang, runCommand, args, input, expected, timeLimit};
+    if (compiled)
+        interact(task);
+    else
+        pendingInteractions.push_back(task);
+}
+
 void Checker::onCompilationStarted()
 {
     log->info(tr("Checker"), tr("Started compiling the checker"));
@@ -133,6 +154,7 @@ void Checker::onCompilationStarted()
 void Checker::clearTasks()
 {
     pendingTasks.clear();
+    pendingInteractions.clear();
     for (auto &t : runners)
     {
         delete t;
@@ -149,16 +171,21 @@ void Checker::onCompilationFinished()
     for (auto const &t : pendingTasks)
         check(t.index, t.input, t.output, t.expected); // solve the pending tasks
     pendingTasks.clear();
+    for (auto const &t : pendingInteractions)
+        interact(t);
+    pendingInteractions.clear();
 }
 
 void Checker::onCompilationErrorOccurred(const QString &error)
 {
     log->error(tr("Checker"), tr("Error occurred while compiling the checker:\n%1").arg(error));
+    emit compilationErrorOccurred(error);
 }
 
 void Checker::onCompilationFailed(const QString &reason)
 {
     log->error(tr("Checker"), tr("Failed to compile the checker: %1").arg(reason), false);
+    emit compilationFailed(reason);
 }
 
 void Checker::onCompilationKilled()
@@ -298,9 +325,9 @@ void Checker::check(int index, const QString &input, const QString &output, cons
         auto inputPath = tmpDir->filePath(QString::number(index) + ".in");
         auto outputPath = tmpDir->filePath(QString::number(index) + ".out");
         auto expectedPath = tmpDir->filePath(QString::number(index) + ".ans");
-        if (Util::saveFile(inputPath, input, tr("Checker"), false, log) &&
-            Util::saveFile(outputPath, output, tr("Checker"), false, log) &&
-            Util::saveFile(expectedPath, expected, tr("Checker"), false, log))
+        if (Util::saveFile(inputPath, input, tr("Checker"), false, log, false, Util::FileKind::Temp) &&
+            Util::saveFile(outputPath, output, tr("Checker"), false, log, false, Util::FileKind::Temp) &&
+            Util::saveFile(expectedPath, expected, tr("Checker"), false, log, false, Util::FileKind::Temp))
         {
             // if files are successfully saved, run the checker
             auto *tmp = new Runner(index);
@@ -317,6 +344,16 @@ void Checker::check(int index, const QString &input, const QString &output, cons
     }
 }
 
+void Checker::interact(const InteractionTask &task)
+{
+    if (task.runner.isNull()) // the runner is deleted while compiling the interactor, e.g. the user runs again
+        return;
+    // the exit code of an interactor is the same as a checker, so its result is handled in the same way
+    connect(task.runner, &Runner::interactorFinished, this, &Checker::onRunFinished);
+    task.runner->runInteractive(task.tmpFilePath, task.sourceFilePath, task.lang, task.runCommand, task.args,
+                                checkerTmpPath, task.input, task.expected, task.timeLimit);
+}
+
 QString Checker::head(int index)
 {
     return tr("Checker[%1]").arg(index + 1);
@@ -23,12 +23,15 @@
  * response is not always immediate.
  * The official testlib checkers are saved in the Qt Resources, and are
  * compiled during the runtime.
+ * A custom checker can also be a testlib interactor, in which case it runs
+ * together with the program, and the verdict is its exit code.
  */
 
 #ifndef CHECKER_HPP
 #define CHECKER_HPP
 
 #include "Widgets/TestCase.hpp"
+#include <QPointer>
 
 class QTemporaryDir;
 class MessageLogger;
@@ -101,6 +104,25 @@ class Checker : public QObject
      */
     void reqeustCheck(int index, const QString &input, const QString &output, const QString &expected);
 
+    /**
+     * @brief request the interactor to run a program interactively
+     * @param runner the runner to run the program, its signals except interactorFinished are handled by the caller
+     * @param tmpFilePath the path to the temporary file which is compiled
+     * @param sourceFilePath the path to the original source file
+     * @param lang the language to run, one of "C++", "Java" and "Python"
+     * @param runCommand the command for running a program
+     * @param args the command line arguments added at the back to start the program
+     * @param input the input of the testcase, passed to the interactor
+     * @param expected the expected output of the testcase, passed to the interactor as the answer file
+     * @param timeLimit the maximum time for the interaction, in milliseconds
+     * @note This should only be used on a custom checker constructed with the path to a testlib interactor.
+     *       The interaction starts after the interactor is compiled, and checkFinished is emitted with the verdict
+     *       of the interactor.
+     */
+    void requestInteraction(Runner *runner, const QString &tmpFilePath, const QString &sourceFilePath,
+                            const QString &lang, const QString &runCommand, const QString &args,
+                            const QString &input, const QString &expected, int timeLimit);
+
     /**
      * @brief clear the pending tasks and kill executing tasks
      */
@@ -114,6 +136,20 @@ class Checker : public QObject
      */
     void checkFinished(int index, Widgets::TestCase::Verdict verdict);
 
+    /**
+     * @brief the testlib checker has compilation errors
+     * @param error the output of the compiler
+     * @note The pending checks are never finished after this.
+     */
+    void compilationErrorOccurred(const QString &error);
+
+    /**
+     * @brief the testlib checker can't be compiled, e.g. the compiler can't be started
+     * @param reason the reason of the failure
+     * @note The pending checks are never finished after this.
+     */
+    void compilationFailed(const QString &reason);
+
   private slots:
     void onCompilationStarted();
 
@@ -177,6 +213,21 @@ class Checker : public QObject
         QString input, output, expected;
     };
 
+    // a struct with the info of an interactive execution, used to save interaction requests
+    struct InteractionTask
+    {
+        QPointer<Runner> runner; // the runner may be deleted before the interactor is compiled
+        QString tmpFilePath, sourceFilePath, lang, runCommand, args, input, expected;
+        int timeLimit;
+    };
+
+    /**
+     * @brief start an interaction
+     * @param task the interaction to start
+     * @note this should only be called when the interactor is compiled
+     */
+    void interact(const InteractionTask &task);
+
     // copied from testlib.h, see #746 for why not include testlib.h
     enum TResult
     {
@@ -202,6 +253,8 @@ class Checker : public QObject
     QVector<Task> pendingTasks;      // the unsolved check requests
     std::atomic<bool> compiled;      // whether the testlib checker is compiled or not
                                      // It should be true for built-in checkers.
+
+    QVector<InteractionTask> pendingInteractions; // the unsolved interaction requests
 };
 
 } // namespace Core
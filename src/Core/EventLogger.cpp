@@ -16,24 +16,133 @@
  */
 
 #include "Core/EventLogger.hpp"
+#include "Core/StartupTracer.hpp"
 #include "Util/FileUtil.hpp"
 #include "generated/portable.hpp"
 #include "generated/version.hpp"
+#include <QCoreApplication>
 #include <QDateTime>
 #include <QDesktopServices>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QLibraryInfo>
+#include <QMutex>
+#include <QPair>
 #include <QProcess>
 #include <QStandardPaths>
 #include <QSysInfo>
+#include <QThread>
 #include <QUrl>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
 
 namespace Core
 {
 
+struct LogEntry
+{
+    LogEntry *next = nullptr; // the next entry in the queue
+    qint64 nsecs;             // the time of the record, nanoseconds since logClock().start
+    Log::Level level;
+    const char *funcName;
+    const char *fileName;
+    int line;
+    QString message;
+};
+
+/**
+ * @brief a monotonic clock for the timestamps, the wall clock time is computed from it when the record is written
+ */
+struct LogClock
+{
+    QElapsedTimer timer;
+    QDateTime start;
+
+    LogClock() : start(QDateTime::currentDateTime())
+    {
+        timer.start();
+    }
+};
+
+static LogClock &logClock()
+{
+    static LogClock clock;
+    return clock;
+}
+
+/**
+ * @brief the writer thread, it writes the records in the queue in batches
+ */
+class LogWriter : public QThread
+{
+  public:
+    void stop()
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        wakeUp.wakeOne();
+    }
+
+    void wake()
+    {
+        // It's fine to wake it up without locking the mutex, the worst case is that the records are written later.
+        wakeUp.wakeOne();
+    }
+
+  protected:
+    void run() override
+    {
+        QMutexLocker locker(&mutex);
+        while (!stopping)
+        {
+            wakeUp.wait(&mutex, WRITE_INTERVAL);
+            locker.unlock();
+            Log::flush();
+            locker.relock();
+        }
+    }
+
+  private:
+    const static int WRITE_INTERVAL = 100; // write the records at least every WRITE_INTERVAL ms
+
+    QMutex mutex; // guards stopping
+    QWaitCondition wakeUp;
+    bool stopping = false;
+};
+
+static LogWriter &logWriter()
+{
+    static LogWriter writer;
+    return writer;
+}
+
+enum WriterState
+{
+    WriterNotStarted, // before Log::init(), the records are kept in the queue
+    WriterRunning,    // the records are written by the writer thread
+    WriterStopped     // after Log::shutdown(), the records are written synchronously
+};
+
+static std::atomic<LogEntry *> queueHead{nullptr}; // a lock-free stack, the newest record is the head
+static std::atomic<int> writerState{WriterNotStarted};
+static QMutex writeMutex; // guards writing to the log file
+
+static const char *const levelNames[] = {"DEBUG", "INFO ", "WARN ", "ERROR", " WTF "}; // shown in the log
+
+static Log::Level defaultLevel = Log::Info;                 // the level of the modules without a rule
+static QVector<QPair<QByteArray, Log::Level>> moduleLevels; // the rules of the modules
+
+const static int DEBUG_RING_SIZE = 256;           // the number of recent debug records kept for crash reports
+const static int MAX_DEBUG_RECORD_SIZE = 4096;    // the maximum length of a kept debug record, the rest is cut off
+static LogEntry *debugRing[DEBUG_RING_SIZE] = {}; // the recent debug records, debugRingNext is the oldest
+static int debugRingNext = 0;                     // the index to put the next debug record
+static QMutex debugRingMutex;                     // guards debugRing and debugRingNext
+
 QFile Log::logFile;
 QTextStream Log::logStream;
+bool Log::debugRecordsKept = false;
 
 const int Log::NUMBER_OF_LOGS_TO_KEEP = 50;
 const int Log::MAXIMUM_FUNCTION_NAME_SIZE = 30;
@@ -41,8 +150,190 @@ const int Log::MAXIMUM_FILE_NAME_SIZE = 30;
 const QString Log::LOG_DIR_NAME = "log";
 const QString Log::LOG_FILE_NAME = "cpeditor";
 
+Log::Record::Record(Level level, const char *funcName, int line, const char *fileName) : entry(new LogEntry)
+{
+    entry->nsecs = logClock().timer.nsecsElapsed();
+    entry->level = level;
+    entry->funcName = funcName;
+    entry->fileName = fileName;
+    entry->line = line;
+    stream.setString(&entry->message, QIODevice::WriteOnly);
+}
+
+Log::Record::~Record()
+{
+    stream.flush();
+    if (isWritten(entry->level, entry->fileName))
+        push(entry, entry->level >= Error);
+    else
+        keepDebugRecord(entry);
+}
+
+void Log::setDebugRecordsKept(bool kept)
+{
+    debugRecordsKept = kept;
+}
+
+bool Log::isWritten(Level level, const char *fileName)
+{
+    for (const auto &rule : moduleLevels)
+    {
+        const auto length = rule.first.length();
+        if (qstrncmp(fileName, rule.first.constData(), length) == 0 &&
+            (fileName[length] == '.' || fileName[length] == '\0'))
+            return level >= rule.second;
+    }
+    return level >= defaultLevel;
+}
+
+bool Log::setFilterRules(const QString &rules)
+{
+    static const QStringList names = {"debug", "info", "warn", "error", "wtf", "off"};
+
+    auto newDefaultLevel = Info;
+    QVector<QPair<QByteArray, Level>> newModuleLevels;
+
+    for (const auto &rule : rules.split(',', Qt::SkipEmptyParts))
+    {
+        const auto parts = rule.split('=');
+        const int index = names.indexOf(parts.last().trimmed().toLower());
+        if (index == -1 || parts.length() > 2)
+            return false;
+        if (parts.length() == 1)
+            newDefaultLevel = static_cast<Level>(index);
+        else
+            newModuleLevels.push_back({parts.first().trimmed().toUtf8(), static_cast<Level>(index)});
+    }
+
+    defaultLevel = newDefaultLevel;
+    moduleLevels = newModuleLevels;
+    return true;
+}
+
+void Log::keepDebugRecord(LogEntry *entry)
+{
+    if (entry->message.size() > MAX_DEBUG_RECORD_SIZE)
+    {
+        entry->message.truncate(MAX_DEBUG_RECORD_SIZE);
+        entry->message += "...";
+    }
+
+    QMutexLocker locker(&debugRingMutex);
+    delete debugRing[debugRingNext];
+    debugRing[debugRingNext] = entry;
+    debugRingNext = (debugRingNext + 1) % DEBUG_RING_SIZE;
+}
+
+void Log::dumpCrashReport(const char *reason)
+{
+    // The application is crashing, don't wait for a long time if another thread is holding the lock.
+    if (!writeMutex.tryLock(100))
+        return;
+
+    writeQueue();
+
+    logStream << "==================== Crashed: " << reason << " ====================\n";
+    if (debugRingMutex.tryLock(100))
+    {
+        logStream << "Recent debug records:\n";
+        for (int i = 0; i < DEBUG_RING_SIZE; ++i)
+        {
+            auto *entry = debugRing[(debugRingNext + i) % DEBUG_RING_SIZE];
+            if (entry != nullptr)
+                write(entry);
+        }
+        debugRingMutex.unlock();
+    }
+    logStream.flush();
+    logFile.flush();
+
+    writeMutex.unlock();
+}
+
+void Log::push(LogEntry *entry, bool urgent)
+{
+    entry->next = queueHead.load(std::memory_order_relaxed);
+    while (!queueHead.compare_exchange_weak(entry->next, entry, std::memory_order_release, std::memory_order_relaxed))
+        ;
+
+    switch (writerState.load(std::memory_order_acquire))
+    {
+    case WriterRunning:
+        if (urgent)
+            logWriter().wake();
+        break;
+    case WriterStopped:
+        flush();
+        break;
+    default:
+        break;
+    }
+}
+
+void Log::flush()
+{
+    QMutexLocker locker(&writeMutex);
+    writeQueue();
+}
+
+void Log::writeQueue()
+{
+    auto *entry = queueHead.exchange(nullptr, std::memory_order_acquire);
+    if (entry == nullptr)
+        return;
+
+    // reverse the stack to write the records in order
+    LogEntry *ordered = nullptr;
+    while (entry != nullptr)
+    {
+        auto *next = entry->next;
+        entry->next = ordered;
+        ordered = entry;
+        entry = next;
+    }
+
+    if (!logFile.isOpen() || !logFile.isWritable())
+        logFile.open(stderr, QIODevice::WriteOnly); // dump to stderr if failed to open log file
+
+    while (ordered != nullptr)
+    {
+        auto *next = ordered->next;
+        write(ordered);
+        delete ordered;
+        ordered = next;
+    }
+
+    logStream.flush();
+}
+
+void Log::write(LogEntry *entry)
+{
+    QString funcName = entry->funcName;
+    if (funcName.size() > MAXIMUM_FUNCTION_NAME_SIZE)
+        funcName = funcName.right(MAXIMUM_FUNCTION_NAME_SIZE);
+
+    QString fileName = entry->fileName;
+    if (fileName.size() > MAXIMUM_FILE_NAME_SIZE)
+        fileName = fileName.right(MAXIMUM_FILE_NAME_SIZE);
+
+    logStream << dateTimeStamp(entry->nsecs) << Qt::center << "[" << levelNames[entry->level] << "]["
+              << qSetFieldWidth(MAXIMUM_FUNCTION_NAME_SIZE) << funcName << qSetFieldWidth(0) << "]["
+              << qSetFieldWidth(MAXIMUM_FILE_NAME_SIZE) << fileName << qSetFieldWidth(0) << Qt::left << "]"
+              << "(" << entry->line << ")::" << entry->message << '\n';
+}
+
+void Log::shutdown()
+{
+    if (writerState.exchange(WriterStopped) != WriterRunning)
+        return;
+    logWriter().stop();
+    logWriter().wait();
+    flush();
+}
+
 void Log::init(unsigned int instance, bool dumptoStderr)
 {
+    TRACE_STARTUP("Core::Log::init");
     logStream.setDevice(&logFile);
     if (!dumptoStderr)
     {
@@ -78,13 +369,18 @@ void Log::init(unsigned int instance, bool dumptoStderr)
     {
         logFile.open(stderr, QIODevice::WriteOnly);
     }
+
+    logWriter().start(QThread::LowPriority);
+    writerState = WriterRunning;
+    qAddPostRoutine(shutdown); // write the remaining records when the application quits
+
     LOG_INFO("Event logger has been initialized successfully");
     platformInformation();
 }
 
-QString Log::dateTimeStamp()
+QString Log::dateTimeStamp(qint64 nsecs)
 {
-    return "[" + QDateTime::currentDateTime().toString(Qt::ISODateWithMs) + "]";
+    return "[" + logClock().start.addMSecs(nsecs / 1000000).toString(Qt::ISODateWithMs) + "]";
 }
 
 void Log::platformInformation()
@@ -118,27 +414,9 @@ void Log::platformInformation()
     LOG_INFO(INFO_OF(__TIME__));
 }
 
-QTextStream &Log::log(const QString &priority, QString funcName, int line, QString fileName)
-{
-    if (!logFile.isOpen() || !logFile.isWritable())
-        logFile.open(stderr, QIODevice::WriteOnly); // dump to stderr if failed to open log file
-    if (funcName.size() > MAXIMUM_FUNCTION_NAME_SIZE)
-        funcName = funcName.right(MAXIMUM_FUNCTION_NAME_SIZE);
-
-    QFileInfo info(fileName);
-    fileName = info.fileName();
-
-    if (fileName.size() > MAXIMUM_FILE_NAME_SIZE)
-        fileName = fileName.right(MAXIMUM_FILE_NAME_SIZE);
-
-    return logStream << dateTimeStamp() << Qt::center << "[" << priority << "]["
-                     << qSetFieldWidth(MAXIMUM_FUNCTION_NAME_SIZE) << funcName << qSetFieldWidth(0) << "]["
-                     << qSetFieldWidth(MAXIMUM_FILE_NAME_SIZE) << fileName << qSetFieldWidth(0) << Qt::left << "]"
-                     << "(" << line << ")::";
-}
-
 void Log::revealInFileManager()
 {
+    flush();
     Util::revealInFileManager(logFile.fileName()).first();
 }
 
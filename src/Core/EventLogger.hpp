@@ -18,6 +18,9 @@
 /*
  * The event logger is used for logging events of the editor.
  * The logs can helps the maintainers find the bug.
+ *
+ * Logging is asynchronous: a log macro only formats the message and pushes it into a lock-free queue, a background
+ * thread formats the timestamps and writes the records into the log file in batches. So it's cheap and thread-safe.
  */
 
 #ifndef EVENTLOGGER_HPP
@@ -26,12 +29,16 @@
 #ifdef QT_DEBUG
 #include <QDebug>
 #endif
+#include <QString>
 #include <QTextStream>
+#include <type_traits>
 
 class QFile;
 
 /**
- * There are four log levels:
+ * There are five log levels:
+ * DEBUG: details, e.g. large payloads, they are not written by default, but with --keep-debug-logs the recent ones
+ *        are kept in memory and written when the application crashes
  * INFO: information, used when everything is normal
  * WARN: warning, used when something strange happened, but it is not necessarily an error
  * ERR: error, used when something bad happened
@@ -43,10 +50,26 @@ class QFile;
  * pure string replacement, we cannot put braces, and hence the no lint.
  */
 
-#define LOG_INFO(stream) Core::Log::log("INFO ", __func__, __LINE__, __FILE__) << stream << Qt::endl; // NOLINT
-#define LOG_WARN(stream) Core::Log::log("WARN ", __func__, __LINE__, __FILE__) << stream << Qt::endl; // NOLINT
-#define LOG_ERR(stream) Core::Log::log("ERROR", __func__, __LINE__, __FILE__) << stream << Qt::endl;  // NOLINT
-#define LOG_WTF(stream) Core::Log::log(" WTF ", __func__, __LINE__, __FILE__) << stream << Qt::endl;  // NOLINT
+/*
+ * The file name of __FILE__ without the directory, computed at compile time.
+ */
+#define LOG_SOURCE_FILE_NAME (__FILE__ + std::integral_constant<int, Core::Log::fileNameOffset(__FILE__)>::value)
+
+/*
+ * The stream is evaluated only if the record is kept, so it's free to log expensive things in a filtered out level.
+ */
+#define LOG_AT(level, stream)                                                                                          \
+    if (!Core::Log::isRecorded(level, LOG_SOURCE_FILE_NAME))                                                           \
+    {                                                                                                                  \
+    }                                                                                                                  \
+    else                                                                                                               \
+        Core::Log::Record(level, __func__, __LINE__, LOG_SOURCE_FILE_NAME) << stream; // NOLINT
+
+#define LOG_DEBUG(stream) LOG_AT(Core::Log::Debug, stream)
+#define LOG_INFO(stream) LOG_AT(Core::Log::Info, stream)
+#define LOG_WARN(stream) LOG_AT(Core::Log::Warn, stream)
+#define LOG_ERR(stream) LOG_AT(Core::Log::Error, stream)
+#define LOG_WTF(stream) LOG_AT(Core::Log::Wtf, stream)
 
 #define LOG_INFO_IF(cond, stream)                                                                                      \
     if (cond)                                                                                                          \
@@ -88,9 +111,65 @@ class QFile;
 
 namespace Core
 {
+struct LogEntry;
+
 class Log
 {
   public:
+    enum Level
+    {
+        Debug,
+        Info,
+        Warn,
+        Error,
+        Wtf,
+        Off // only used in the filter rules
+    };
+
+    /**
+     * @brief a log record being written, it's pushed into the queue when it's destructed
+     */
+    class Record
+    {
+      public:
+        /**
+         * @param level the level of the record
+         * @param funcName the function name, it must live until the record is written, e.g. __func__
+         * @param line the line number
+         * @param fileName the file name, it must be a string literal
+         */
+        Record(Level level, const char *funcName, int line, const char *fileName);
+        ~Record();
+
+        Record(const Record &) = delete;
+        Record &operator=(const Record &) = delete;
+
+        template <typename T> Record &operator<<(const T &value)
+        {
+            stream << value;
+            return *this;
+        }
+
+      private:
+        LogEntry *entry;    // the entry pushed into the queue
+        QTextStream stream; // writes to entry->message
+    };
+
+    /**
+     * @brief get the offset of the file name in a path
+     * @note This is constexpr so that LOG_SOURCE_FILE_NAME can be computed at compile time.
+     */
+    static constexpr int fileNameOffset(const char *path)
+    {
+        int offset = 0;
+        for (int i = 0; path[i] != '\0'; ++i)
+        {
+            if (path[i] == '/' || path[i] == '\\')
+                offset = i + 1;
+        }
+        return offset;
+    }
+
     /**
      * @brief initialize the event logger
      * @param instance the instance ID provided by SingleApplication, to distinct processes from each other
@@ -110,14 +189,60 @@ class Log
      */
     static void revealInFileManager();
 
-    static QTextStream &log(const QString &priority, QString funcName, int line, QString fileName);
+    /**
+     * @brief write all records in the queue synchronously
+     */
+    static void flush();
+
+    /**
+     * @brief set the levels of the records to write
+     * @param rules a comma-separated list of "<level>" or "<module>=<level>", where <module> is the source file name
+     * without the extension, e.g. "warn,CompanionServer=debug". The level is one of debug, info, warn, error, wtf, off.
+     * @returns false if the rules are invalid, in which case nothing is changed
+     * @note This should be called before logging in other threads. The default level is info.
+     */
+    static bool setFilterRules(const QString &rules);
+
+    /**
+     * @brief set whether the recent debug records are kept in memory for the crash report, even if not written
+     * @note This should be called before logging in other threads. It's off by default, because the arguments of
+     *       LOG_DEBUG are evaluated for every kept record, and some of them are large, e.g. the LSP messages.
+     */
+    static void setDebugRecordsKept(bool kept);
+
+    /**
+     * @brief whether a record is written into the log file
+     */
+    static bool isWritten(Level level, const char *fileName);
+
+    /**
+     * @brief whether a record should be created, i.e. it's written or kept in the crash buffer
+     */
+    static bool isRecorded(Level level, const char *fileName)
+    {
+        return (level == Debug && debugRecordsKept) || isWritten(level, fileName);
+    }
+
+    /**
+     * @brief write the queued records and the recent debug records when the application crashes
+     * @param reason the reason of the crash, e.g. the signal name
+     * @note This is best-effort, it gives up if another thread is writing the log.
+     */
+    static void dumpCrashReport(const char *reason);
 
   private:
-    static QString dateTimeStamp();
+    static void push(LogEntry *entry, bool urgent);
+    static void keepDebugRecord(LogEntry *entry);
+    static void writeQueue();
+    static void write(LogEntry *entry);
+    static void shutdown();
+
+    static QString dateTimeStamp(qint64 nsecs);
     static void platformInformation();
 
     static QTextStream logStream; // the text stream for logging, writes to logFile
     static QFile logFile;         // the device for logging, a file or stderr
+    static bool debugRecordsKept; // whether the debug records not written are kept for the crash report
 
     const static int NUMBER_OF_LOGS_TO_KEEP; // Number of log files to keep in Temporary directory
     const static QString LOG_FILE_NAME;      // Base Name of the log file
@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/FileWatcher.hpp"
+#include "Core/EventLogger.hpp"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <algorithm>
+
+#ifndef Q_OS_WIN
+#include <sys/stat.h>
+#endif
+
+namespace Core
+{
+FileWatcher *FileWatcher::instance()
+{
+    static auto *watcher = new FileWatcher(qApp);
+    return watcher;
+}
+
+FileWatcher::FileWatcher(QObject *parent)
+    : QObject(parent), watcher(new QFileSystemWatcher(this)), debounceTimer(new QTimer(this))
+{
+    debounceTimer->setSingleShot(true);
+    debounceTimer->setInterval(DEBOUNCE_INTERVAL);
+    connect(debounceTimer, &QTimer::timeout, this, &FileWatcher::checkPendingFiles);
+    connect(watcher, &QFileSystemWatcher::fileChanged, this, &FileWatcher::onFileChanged);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this, &FileWatcher::onDirectoryChanged);
+}
+
+void FileWatcher::watch(QObject *receiver, const QString &path, const Callback &callback)
+{
+    const auto absolutePath = QFileInfo(path).absoluteFilePath();
+
+    addReceiver(receiver);
+
+    auto &list = subscriptions[absolutePath];
+    list.push_back({receiver, callback});
+    if (list.size() > 1)
+        return;
+
+    const auto state = stat(absolutePath);
+    states[absolutePath] = state;
+    if (state.exists)
+        watcher->addPath(absolutePath);
+    addDirectory(absolutePath);
+}
+
+void FileWatcher::watchDirectory(QObject *receiver, const QString &path, const DirectoryCallback &callback)
+{
+    const auto absolutePath = QFileInfo(path).absoluteFilePath();
+
+    addReceiver(receiver);
+
+    auto &list = directorySubscriptions[absolutePath];
+    list.push_back({receiver, callback});
+    if (list.size() == 1 && !directories.contains(absolutePath))
+        watcher->addPath(absolutePath);
+}
+
+void FileWatcher::unwatch(QObject *receiver, const QString &path)
+{
+    const auto directoryPaths =
+        path.isEmpty() ? directorySubscriptions.keys() : QStringList(QFileInfo(path).absoluteFilePath());
+    for (const auto &directoryPath : directoryPaths)
+    {
+        auto it = directorySubscriptions.find(directoryPath);
+        if (it == directorySubscriptions.end())
+            continue;
+        auto &list = it.value();
+        list.erase(std::remove_if(list.begin(), list.end(),
+                                  [receiver](const DirectorySubscription &subscription) {
+                                      return subscription.receiver.isNull() || subscription.receiver == receiver;
+                                  }),
+                   list.end());
+        if (!list.isEmpty())
+            continue;
+
+        directorySubscriptions.erase(it);
+        pendingDirectories.remove(directoryPath);
+        if (!directories.contains(directoryPath))
+            watcher->removePath(directoryPath);
+    }
+
+    const auto paths = path.isEmpty() ? subscriptions.keys() : QStringList(QFileInfo(path).absoluteFilePath());
+    for (const auto &filePath : paths)
+    {
+        auto it = subscriptions.find(filePath);
+        if (it == subscriptions.end())
+            continue;
+        auto &list = it.value();
+        list.erase(std::remove_if(list.begin(), list.end(),
+                                  [receiver](const Subscription &subscription) {
+                                      return subscription.receiver.isNull() || subscription.receiver == receiver;
+                                  }),
+                   list.end());
+        if (!list.isEmpty())
+            continue;
+
+        subscriptions.erase(it);
+        states.remove(filePath);
+        pendingFiles.remove(filePath);
+        watcher->removePath(filePath);
+        removeDirectory(filePath);
+    }
+}
+
+void FileWatcher::setWrittenContent(const QString &path, const QByteArray &hash)
+{
+    const auto absolutePath = QFileInfo(path).absoluteFilePath();
+    auto it = states.find(absolutePath);
+    if (it == states.end())
+        return;
+    auto state = stat(absolutePath);
+    if (state.exists && !it->exists)
+    {
+        // the parent directory may be created together with the file
+        watcher->addPath(QFileInfo(absolutePath).absolutePath());
+        watcher->addPath(absolutePath);
+    }
+    state.hash = hash;
+    *it = state;
+}
+
+void FileWatcher::onFileChanged(const QString &path)
+{
+    schedule(path);
+}
+
+void FileWatcher::onDirectoryChanged(const QString &path)
+{
+    // the files in the directory may be created, removed or replaced
+    for (const auto &filePath : directories.value(path))
+        schedule(filePath);
+
+    if (directorySubscriptions.contains(path))
+    {
+        pendingDirectories.insert(path);
+        if (!debounceTimer->isActive())
+            debounceTimer->start();
+    }
+}
+
+void FileWatcher::checkPendingFiles()
+{
+    const auto files = pendingFiles;
+    pendingFiles.clear();
+    for (const auto &path : files)
+        check(path);
+
+    const auto directoryPaths = pendingDirectories;
+    pendingDirectories.clear();
+    for (const auto &path : directoryPaths)
+    {
+        // the callbacks may unwatch directories or destroy the receivers
+        const auto list = directorySubscriptions.value(path);
+        for (const auto &subscription : list)
+        {
+            if (!subscription.receiver.isNull())
+                subscription.callback(path);
+        }
+    }
+}
+
+FileWatcher::FileState FileWatcher::stat(const QString &path)
+{
+    FileState state;
+    const QFileInfo info(path);
+    state.exists = info.exists();
+    if (state.exists)
+    {
+        state.size = info.size();
+        state.lastModified = info.lastModified();
+#ifndef Q_OS_WIN
+        struct stat buf; // NOLINT
+        if (::stat(QFile::encodeName(path).constData(), &buf) == 0)
+            state.inode = buf.st_ino;
+#endif
+    }
+    return state;
+}
+
+void FileWatcher::addReceiver(QObject *receiver)
+{
+    if (receivers.contains(receiver))
+        return;
+    receivers.insert(receiver);
+    connect(receiver, &QObject::destroyed, this, [this, receiver] {
+        unwatch(receiver);
+        receivers.remove(receiver);
+    });
+}
+
+void FileWatcher::check(const QString &path)
+{
+    auto it = states.find(path);
+    if (it == states.end())
+        return;
+
+    auto current = stat(path);
+
+    // a created file, or a file replaced by renaming, is not watched by the QFileSystemWatcher any more
+    if (current.exists && (!it->exists || current.inode != it->inode))
+        watcher->addPath(path);
+
+    if (current.exists == it->exists && current.size == it->size && current.lastModified == it->lastModified &&
+        current.inode == it->inode)
+        return;
+
+    QString content;
+    if (current.exists)
+    {
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text))
+        {
+            const auto data = file.readAll();
+            current.hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+            content = QString::fromUtf8(data);
+            if (content.isNull())
+                content = "";
+        }
+    }
+
+    const bool changed = current.hash != it->hash || current.exists != it->exists;
+    *it = current;
+    if (!changed)
+        return;
+
+    LOG_INFO("The file is changed: " << path);
+
+    // the callbacks may unwatch files or destroy the receivers
+    const auto list = subscriptions.value(path);
+    for (const auto &subscription : list)
+    {
+        if (!subscription.receiver.isNull())
+            subscription.callback(path, content);
+    }
+}
+
+void FileWatcher::schedule(const QString &path)
+{
+    pendingFiles.insert(path);
+    if (!debounceTimer->isActive())
+        debounceTimer->start();
+}
+
+void FileWatcher::addDirectory(const QString &path)
+{
+    const auto directory = QFileInfo(path).absolutePath();
+    auto &files = directories[directory];
+    if (files.isEmpty() && !directorySubscriptions.contains(directory))
+        watcher->addPath(directory);
+    files.insert(path);
+}
+
+void FileWatcher::removeDirectory(const QString &path)
+{
+    const auto directory = QFileInfo(path).absolutePath();
+    auto it = directories.find(directory);
+    if (it == directories.end())
+        return;
+    it->remove(path);
+    if (it->isEmpty())
+    {
+        directories.erase(it);
+        if (!directorySubscriptions.contains(directory))
+            watcher->removePath(directory);
+    }
+}
+} // namespace Core
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+/*
+ * The FileWatcher watches the files opened in all tabs with a single QFileSystemWatcher.
+ * The events are coalesced, and a file is read only if its size, modification time or inode is changed. The content
+ * is compared by its hash, and only the receivers watching the changed file are notified.
+ * The parent directories are watched as well, so that the files created later, or replaced by renaming, are noticed.
+ * A directory can also be watched by itself, so that the files that may be created in it don't need a watch each.
+ */
+
+#ifndef FILEWATCHER_HPP
+#define FILEWATCHER_HPP
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QVector>
+#include <functional>
+
+class QFileSystemWatcher;
+class QTimer;
+
+namespace Core
+{
+class FileWatcher : public QObject
+{
+    Q_OBJECT
+
+  public:
+    /**
+     * @param path the absolute path to the file
+     * @param content the new content of the file, a null QString if it's removed or can't be read
+     */
+    using Callback = std::function<void(const QString &path, const QString &content)>;
+
+    /**
+     * @param path the absolute path to the directory
+     */
+    using DirectoryCallback = std::function<void(const QString &path)>;
+
+    static FileWatcher *instance();
+
+    /**
+     * @brief call *callback* when the content of a file is changed
+     * @param receiver the owner of the callback, it's unwatched when the receiver is destroyed
+     * @param path the path to the file, it doesn't need to exist
+     * @note The callback is not called for the content already on the disk.
+     */
+    void watch(QObject *receiver, const QString &path, const Callback &callback);
+
+    /**
+     * @brief call *callback* when files are created, removed or renamed in a directory
+     * @param receiver the owner of the callback, it's unwatched when the receiver is destroyed
+     * @param path the path to the directory, it should exist
+     */
+    void watchDirectory(QObject *receiver, const QString &path, const DirectoryCallback &callback);
+
+    /**
+     * @brief stop calling the callbacks of *receiver*
+     * @param path the path of the file or the directory to stop watching, or all paths if it's empty
+     */
+    void unwatch(QObject *receiver, const QString &path = QString());
+
+    /**
+     * @brief tell the watcher that the file is written by us, so that it's not reported as a change
+     * @param hash the SHA-1 hash of the content in UTF-8
+     * @note It does nothing if the file is not watched.
+     */
+    void setWrittenContent(const QString &path, const QByteArray &hash);
+
+  private slots:
+    void onFileChanged(const QString &path);
+    void onDirectoryChanged(const QString &path);
+    void checkPendingFiles();
+
+  private:
+    struct Subscription
+    {
+        QPointer<QObject> receiver; // null if it's destroyed while the callbacks are being called
+        Callback callback;
+    };
+
+    struct DirectorySubscription
+    {
+        QPointer<QObject> receiver;
+        DirectoryCallback callback;
+    };
+
+    struct FileState
+    {
+        bool exists = false;
+        qint64 size = -1;
+        QDateTime lastModified;
+        quint64 inode = 0;
+        QByteArray hash; // the hash of the content, empty if it's not read yet
+    };
+
+    explicit FileWatcher(QObject *parent = nullptr);
+
+    /**
+     * @brief get the metadata of a file, the hash is not set
+     */
+    static FileState stat(const QString &path);
+
+    void addReceiver(QObject *receiver);
+    void check(const QString &path);
+    void schedule(const QString &path);
+    void addDirectory(const QString &path);
+    void removeDirectory(const QString &path);
+
+    const static int DEBOUNCE_INTERVAL = 100; // the events in this time after the first one are coalesced (ms)
+
+    QFileSystemWatcher *watcher = nullptr;
+    QTimer *debounceTimer = nullptr;
+    QHash<QString, QVector<Subscription>> subscriptions;                   // by the absolute file paths
+    QHash<QString, QVector<DirectorySubscription>> directorySubscriptions; // by the absolute directory paths
+    QHash<QString, FileState> states;          // the last known states of the watched files
+    QHash<QString, QSet<QString>> directories; // the parent directories, and the watched files in them
+    QSet<QString> pendingFiles;                // the files to check when debounceTimer times out
+    QSet<QString> pendingDirectories;          // the watched directories to report when debounceTimer times out
+    QSet<QObject *> receivers;                 // the receivers connected to unwatch() on destruction
+};
+} // namespace Core
+
+#endif // FILEWATCHER_HPP
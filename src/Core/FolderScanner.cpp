@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/FolderScanner.hpp"
+#include "Core/EventLogger.hpp"
+#include "Util/FunctionRunnable.hpp"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSet>
+#include <QThreadPool>
+#include <QVector>
+
+namespace Core
+{
+FolderScanner::FolderScanner(const QStringList &suffixes, QObject *parent) : QObject(parent), suffixes(suffixes)
+{
+    workerPool = new QThreadPool(this);
+    workerPool->setMaxThreadCount(1);
+}
+
+FolderScanner::~FolderScanner()
+{
+    // scan() uses the members, so it must finish before they are destructed
+    cancelled = true;
+    workerPool->waitForDone();
+}
+
+void FolderScanner::start(const QStringList &folders, int depth)
+{
+    LOG_INFO(INFO_OF(folders.join(" ")) << INFO_OF(depth));
+    workerPool->start(new Util::FunctionRunnable([this, folders, depth] { scan(folders, depth); }));
+}
+
+void FolderScanner::cancel()
+{
+    LOG_INFO("Folder scan cancelled");
+    cancelled = true;
+}
+
+void FolderScanner::scan(const QStringList &folders, int depth)
+{
+    struct Folder
+    {
+        QString path;
+        int depth;
+    };
+
+    QVector<Folder> stack;
+    for (auto it = folders.crbegin(); it != folders.crend(); ++it)
+        stack.push_back({*it, depth});
+
+    QSet<QString> scanned; // the canonical paths of the scanned folders
+    QStringList batch;
+    QElapsedTimer batchTimer;
+    batchTimer.start();
+
+    while (!stack.isEmpty() && !cancelled)
+    {
+        const auto folder = stack.takeLast();
+
+        // a folder reached again through a symbolic link, which may be a loop
+        const auto canonicalPath = QFileInfo(folder.path).canonicalFilePath();
+        if (canonicalPath.isEmpty() || scanned.contains(canonicalPath))
+            continue;
+        scanned.insert(canonicalPath);
+
+        QVector<Folder> subFolders;
+        for (auto const &entry : QDir(canonicalPath).entryInfoList(QDir::NoDotAndDotDot | QDir::AllEntries))
+        {
+            if (entry.isDir())
+            {
+                if (folder.depth != 0)
+                    subFolders.push_back({entry.filePath(), folder.depth == -1 ? -1 : folder.depth - 1});
+            }
+            else if (suffixes.contains(entry.suffix()))
+            {
+                batch.push_back(entry.canonicalFilePath());
+            }
+        }
+
+        // push in the reverse order, so that the sub-folders are scanned in the order of their names
+        for (auto it = subFolders.crbegin(); it != subFolders.crend(); ++it)
+            stack.push_back(*it);
+
+        if (batch.size() >= BATCH_SIZE || (!batch.isEmpty() && batchTimer.elapsed() >= BATCH_INTERVAL))
+        {
+            report(batch);
+            batch.clear();
+            batchTimer.restart();
+        }
+    }
+
+    if (!batch.isEmpty())
+        report(batch);
+
+    const bool wasCancelled = cancelled;
+    QMetaObject::invokeMethod(
+        this, [this, wasCancelled] { emit finished(wasCancelled); }, Qt::QueuedConnection);
+}
+
+void FolderScanner::report(const QStringList &paths)
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this, paths] {
+            if (!cancelled)
+                emit filesFound(paths);
+        },
+        Qt::QueuedConnection);
+}
+} // namespace Core
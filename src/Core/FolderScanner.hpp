@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+/*
+ * The FolderScanner finds the source files in folders on a worker thread.
+ * The files are reported in batches while scanning, so the caller can open them before the scan is finished.
+ * Symbolic links to folders are followed, but each folder is scanned at most once, so a link can't cause a loop.
+ * The scan can be cancelled at any time, and it stops after the folder being scanned.
+ */
+
+#ifndef FOLDERSCANNER_HPP
+#define FOLDERSCANNER_HPP
+
+#include <QObject>
+#include <QStringList>
+#include <atomic>
+
+class QThreadPool;
+
+namespace Core
+{
+class FolderScanner : public QObject
+{
+    Q_OBJECT
+
+  public:
+    /**
+     * @brief construct a folder scanner
+     * @param suffixes the suffixes of the files to find, e.g. "cpp"
+     * @param parent the parent of a QObject
+     */
+    explicit FolderScanner(const QStringList &suffixes, QObject *parent = nullptr);
+
+    /**
+     * @brief destruct the folder scanner
+     * @note It cancels the scan and waits for the worker thread.
+     */
+    ~FolderScanner() override;
+
+    /**
+     * @brief start scanning on the worker thread
+     * @param folders the folders to scan
+     * @param depth the depth of the sub-folders to scan, 0 for only the files in *folders*, -1 for unlimited
+     * @note This should be called only once. Please create multiple FolderScanners for multiple scans.
+     */
+    void start(const QStringList &folders, int depth);
+
+    /**
+     * @brief cancel the scan
+     * @note filesFound won't be emitted after this, but finished is still emitted
+     */
+    void cancel();
+
+  signals:
+    /**
+     * @brief some files are found
+     * @param paths the canonical paths of the files
+     */
+    void filesFound(const QStringList &paths);
+
+    /**
+     * @brief the scan is finished
+     * @param cancelled whether the scan is cancelled before all the folders are scanned
+     */
+    void finished(bool cancelled);
+
+  private:
+    /**
+     * @brief scan the folders depth-first
+     * @note This runs on the worker thread, so it must not log or touch any widget.
+     */
+    void scan(const QStringList &folders, int depth);
+
+    /**
+     * @brief emit filesFound on the thread of the scanner
+     * @note This is called on the worker thread.
+     */
+    void report(const QStringList &paths);
+
+    const QStringList suffixes;         // the suffixes of the files to find
+    QThreadPool *workerPool = nullptr;  // runs scan()
+    std::atomic<bool> cancelled{false}; // whether cancel() is called
+
+    const static int BATCH_SIZE = 64;      // report the found files when there are this many of them
+    const static int BATCH_INTERVAL = 100; // or when they are found this long ago (ms)
+};
+} // namespace Core
+
+#endif // FOLDERSCANNER_HPP
@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/Judge.hpp"
+#include "Core/Checker.hpp"
+#include "Core/Compiler.hpp"
+#include "Core/EventLogger.hpp"
+#include "Core/MessageLogger.hpp"
+#include "Core/Runner.hpp"
+#include "Settings/SettingsManager.hpp"
+#include "Util/FileUtil.hpp"
+#include "generated/SettingsHelper.hpp"
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QTemporaryDir>
+#include <QTimer>
+
+namespace Core
+{
+
+Judge::Judge(QObject *parent) : QObject(parent)
+{
+}
+
+Judge::~Judge()
+{
+    // the runners and the compiler kill their processes when they are destructed
+    qDeleteAll(runners);
+    delete compiler;
+    delete checker;
+    delete log;
+    delete tmpDir;
+}
+
+void Judge::start(const QString &sourcePath, const QString &lang, const QVector<TestCase> &testCases, int timeLimit,
+                  const QString &checker)
+{
+    LOG_INFO(INFO_OF(sourcePath) << INFO_OF(lang) << INFO_OF(testCases.size()) << INFO_OF(timeLimit)
+                                 << INFO_OF(checker));
+
+    timer.start();
+    this->sourcePath = sourcePath;
+    this->lang = lang;
+    this->timeLimit = timeLimit;
+    this->testCases = testCases;
+    results.resize(testCases.size());
+    remaining = testCases.size();
+
+    if (!QStringList({"C++", "Java", "Python"}).contains(lang))
+        return fail("failed", tr("Unknown language [%1]").arg(lang));
+
+    const auto source = Util::readFile(sourcePath, tr("Judge"));
+    if (source.isNull())
+        return fail("failed", tr("Failed to read the source file [%1]").arg(sourcePath));
+
+    tmpDir = new QTemporaryDir();
+    if (!tmpDir->isValid())
+        return fail("failed", tr("Failed to create the temporary directory"));
+
+    // the same file names as the ones used by the tabs, the class name matters for Java
+    QString name;
+    if (lang == "C++")
+        name = "sol." + Util::cppSuffix.first();
+    else if (lang == "Java")
+        name = SettingsHelper::getJavaClassName() + "." + Util::javaSuffix.first();
+    else
+        name = "sol." + Util::pythonSuffix.first();
+    tmpFilePath = tmpDir->filePath(name);
+    if (!Util::saveFile(tmpFilePath, source, tr("Judge"), false, nullptr, false, Util::FileKind::Temp))
+        return fail("failed", tr("Failed to write the temporary file"));
+
+    log = new MessageLogger(nullptr);
+    connect(log, &MessageLogger::messageLogged, this,
+            [this](const QString &head, const QString &body) { checkerMessages.push_back(head + ": " + body); });
+
+    checkTimer = new QTimer(this);
+    checkTimer->setSingleShot(true);
+    checkTimer->setInterval(CHECK_TIMEOUT);
+    connect(checkTimer, &QTimer::timeout, this, &Judge::onCheckTimeout);
+
+    const auto checkerType = checkerNames().indexOf(checker);
+    if (checkerType != -1)
+        this->checker = new Checker(Checker::CheckerType(checkerType), log, this);
+    else if (QFileInfo(checker).isFile())
+        this->checker = new Checker(checker, log, this);
+    else
+        return fail("failed", tr("Unknown checker [%1]").arg(checker));
+    connect(this->checker, &Checker::checkFinished, this, &Judge::onCheckFinished);
+    connect(this->checker, &Checker::compilationErrorOccurred, this, &Judge::onCheckerCompilationErrorOccurred);
+    connect(this->checker, &Checker::compilationFailed, this, &Judge::onCheckerCompilationFailed);
+    this->checker->prepare();
+
+    if (lang == "Python")
+    {
+        onCompilationFinished();
+        return;
+    }
+
+    compiler = new Compiler();
+    connect(compiler, &Compiler::compilationFinished, this, &Judge::onCompilationFinished);
+    connect(compiler, &Compiler::compilationErrorOccurred, this, &Judge::onCompilationErrorOccurred);
+    connect(compiler, &Compiler::compilationFailed, this, &Judge::onCompilationFailed);
+    compiler->start(tmpFilePath, sourcePath, SettingsManager::get(QString("%1/Compile Command").arg(lang)).toString(),
+                    lang);
+}
+
+QStringList Judge::checkerNames()
+{
+    return {"ignoreTrailingSpaces", "strict", "ncmp", "rcmp4", "rcmp6", "rcmp9", "wcmp", "nyesno"};
+}
+
+void Judge::onCompilationFinished()
+{
+    compileTime = timer.elapsed();
+    LOG_INFO(INFO_OF(compileTime));
+    runTestCases();
+}
+
+void Judge::onCompilationErrorOccurred(const QString &error)
+{
+    fail("compilationError", error);
+}
+
+void Judge::onCompilationFailed(const QString &reason)
+{
+    fail("failed", reason);
+}
+
+void Judge::runTestCases()
+{
+    if (testCases.isEmpty())
+    {
+        finishTestCase(-1, Widgets::TestCase::UNKNOWN);
+        return;
+    }
+
+    const auto runCommand = SettingsManager::get(QString("%1/Run Command").arg(lang)).toString();
+    const auto runArguments = SettingsManager::get(QString("%1/Run Arguments").arg(lang)).toString();
+
+    for (int i = 0; i < testCases.size(); ++i)
+    {
+        auto *runner = new Runner(i);
+        connect(runner, &Runner::runFinished, this, &Judge::onRunFinished);
+        connect(runner, &Runner::failedToStartRun, this, &Judge::onFailedToStartRun);
+        connect(runner, &Runner::runOutputLimitExceeded, this, &Judge::onRunOutputLimitExceeded);
+        runners.push_back(runner);
+        runner->run(tmpFilePath, sourcePath, lang, runCommand, runArguments, testCases[i].input, timeLimit);
+    }
+}
+
+void Judge::onRunFinished(int index, const QString &out, const QString &err, int exitCode, qint64 timeUsed, bool tle)
+{
+    auto &result = results[index];
+    result.output = out;
+    // the message of onRunOutputLimitExceeded() may be set already, it's appended to the stderr
+    if (result.error.isEmpty() || err.isEmpty())
+        result.error = err + result.error;
+    else
+        result.error = err + '\n' + result.error;
+    result.exitCode = exitCode;
+    result.timeUsed = timeUsed;
+
+    if (exitCode != 0)
+        finishTestCase(index, tle ? Widgets::TestCase::TLE : Widgets::TestCase::RE);
+    else if ((!out.isEmpty() && !testCases[index].expected.isEmpty()) ||
+             SettingsHelper::isCheckOnTestcasesWithEmptyOutput())
+    {
+        result.checking = true;
+        checker->reqeustCheck(index, testCases[index].input, out, testCases[index].expected);
+        if (!checkTimer->isActive())
+            checkTimer->start();
+    }
+    else
+        finishTestCase(index, Widgets::TestCase::UNKNOWN);
+}
+
+void Judge::onFailedToStartRun(int index, const QString &error)
+{
+    results[index].error = error;
+    finishTestCase(index, Widgets::TestCase::RE);
+}
+
+void Judge::onRunOutputLimitExceeded(int index, const QString &type)
+{
+    // the process is killed, and runFinished is emitted with the output so far, before which the stderr is unknown
+    results[index].error = tr("The %1 is longer than the output length limit").arg(type);
+}
+
+void Judge::onCheckFinished(int index, Widgets::TestCase::Verdict verdict)
+{
+    finishTestCase(index, verdict);
+}
+
+void Judge::onCheckerCompilationErrorOccurred(const QString &error)
+{
+    fail("checkerError", tr("Error occurred while compiling the checker:\n%1").arg(error));
+}
+
+void Judge::onCheckerCompilationFailed(const QString &reason)
+{
+    fail("checkerError", tr("Failed to compile the checker: %1").arg(reason));
+}
+
+void Judge::onCheckTimeout()
+{
+    LOG_WARN("The checker didn't finish in time");
+    for (int i = 0; i < results.size(); ++i)
+    {
+        if (results[i].checking && !results[i].done)
+        {
+            results[i].error = tr("The checker didn't finish in time");
+            finishTestCase(i, Widgets::TestCase::UNKNOWN);
+        }
+    }
+}
+
+void Judge::finishTestCase(int index, Widgets::TestCase::Verdict verdict)
+{
+    if (index != -1)
+    {
+        if (results[index].done)
+            return;
+        results[index].done = true;
+        results[index].verdict = verdict;
+        --remaining;
+    }
+
+    if (remaining > 0 || reported)
+        return;
+    reported = true;
+
+    QJsonArray tests;
+    QJsonObject summary;
+    bool accepted = !results.isEmpty();
+    for (const auto &result : results)
+    {
+        const auto name = verdictName(result.verdict);
+        tests.push_back(QJsonObject{{"verdict", name},
+                                    {"time", result.timeUsed},
+                                    {"exitCode", result.exitCode},
+                                    {"output", result.output},
+                                    {"stderr", result.error}});
+        summary[name] = summary[name].toInt() + 1;
+        accepted = accepted && result.verdict == Widgets::TestCase::AC;
+    }
+
+    LOG_INFO("Judge finished " << INFO_OF(sourcePath) << INFO_OF(accepted));
+
+    emit finished(QJsonObject{{"status", "finished"},
+                              {"file", sourcePath},
+                              {"language", lang},
+                              {"accepted", accepted},
+                              {"compileTime", compileTime},
+                              {"totalTime", timer.elapsed()},
+                              {"summary", summary},
+                              {"tests", tests},
+                              {"checkerMessages", QJsonArray::fromStringList(checkerMessages)}});
+}
+
+void Judge::fail(const QString &status, const QString &message)
+{
+    if (reported)
+        return;
+    reported = true;
+    LOG_WARN(INFO_OF(status) << INFO_OF(message));
+    emit finished(QJsonObject{{"status", status},
+                              {"file", sourcePath},
+                              {"language", lang},
+                              {"accepted", false},
+                              {"message", message},
+                              {"checkerMessages", QJsonArray::fromStringList(checkerMessages)}});
+}
+
+QString Judge::verdictName(Widgets::TestCase::Verdict verdict)
+{
+    switch (verdict)
+    {
+    case Widgets::TestCase::AC:
+        return "AC";
+    case Widgets::TestCase::WA:
+        return "WA";
+    case Widgets::TestCase::TLE:
+        return "TLE";
+    case Widgets::TestCase::RE:
+        return "RE";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+} // namespace Core
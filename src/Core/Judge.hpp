@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+/*
+ * The Judge compiles a source file, runs it on the given test cases and checks the outputs, without a tab.
+ * It uses the Compiler, the Runner and the Checker in the same way as a tab does, with the settings of the language.
+ * The result is reported as a JSON object, which is used by the local API and the command line judge.
+ * Like the Compiler and the Runner, a Judge should be used only once.
+ */
+
+#ifndef JUDGE_HPP
+#define JUDGE_HPP
+
+#include "Widgets/TestCase.hpp"
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QObject>
+#include <QVector>
+
+class MessageLogger;
+class QTemporaryDir;
+class QTimer;
+
+namespace Core
+{
+class Checker;
+class Compiler;
+class Runner;
+
+class Judge : public QObject
+{
+    Q_OBJECT
+
+  public:
+    struct TestCase
+    {
+        QString input;
+        QString expected;
+    };
+
+    explicit Judge(QObject *parent = nullptr);
+
+    /**
+     * @brief destruct the judge
+     * @note the running compiler, runners and checker are killed
+     */
+    ~Judge() override;
+
+    /**
+     * @brief start judging
+     * @param sourcePath the path to the source file
+     * @param lang the language of the source file, one of "C++", "Java" and "Python"
+     * @param testCases the test cases to run on
+     * @param timeLimit the time limit of each test case (ms)
+     * @param checker the name of a built-in checker (e.g. "wcmp"), or the path to a custom checker
+     * @note finished() is emitted when it's done, even if it fails
+     */
+    void start(const QString &sourcePath, const QString &lang, const QVector<TestCase> &testCases, int timeLimit,
+               const QString &checker);
+
+    /**
+     * @brief the names of the built-in checkers, in the order of Checker::CheckerType
+     */
+    static QStringList checkerNames();
+
+  signals:
+    /**
+     * @brief judging is finished
+     * @param report the result, with "status" in "finished", "compilationError", "checkerError" and "failed", and
+     * the messages of the checker in "checkerMessages"
+     */
+    void finished(const QJsonObject &report);
+
+  private slots:
+    void onCompilationFinished();
+    void onCompilationErrorOccurred(const QString &error);
+    void onCompilationFailed(const QString &reason);
+    void onRunFinished(int index, const QString &out, const QString &err, int exitCode, qint64 timeUsed, bool tle);
+    void onFailedToStartRun(int index, const QString &error);
+    void onRunOutputLimitExceeded(int index, const QString &type);
+    void onCheckFinished(int index, Widgets::TestCase::Verdict verdict);
+    void onCheckerCompilationErrorOccurred(const QString &error);
+    void onCheckerCompilationFailed(const QString &reason);
+    void onCheckTimeout();
+
+  private:
+    struct Result
+    {
+        Widgets::TestCase::Verdict verdict = Widgets::TestCase::UNKNOWN;
+        bool done = false;
+        bool checking = false; // whether it's waiting for the checker
+        int exitCode = 0;
+        qint64 timeUsed = 0;
+        QString output, error;
+    };
+
+    /**
+     * @brief run all test cases after the compilation
+     */
+    void runTestCases();
+
+    /**
+     * @brief mark a test case as done, and report if all test cases are done
+     */
+    void finishTestCase(int index, Widgets::TestCase::Verdict verdict);
+
+    /**
+     * @brief report a failure before running the test cases
+     */
+    void fail(const QString &status, const QString &message);
+
+    static QString verdictName(Widgets::TestCase::Verdict verdict);
+
+    const static int CHECK_TIMEOUT = 30000; // the time to wait for the checker, e.g. if it crashes (ms)
+
+  private:
+    QString sourcePath;
+    QString tmpFilePath; // the copy of the source file which is compiled and run
+    QString lang;
+    int timeLimit = 0;
+    QVector<TestCase> testCases;
+    QVector<Result> results;
+    int remaining = 0;                     // the number of test cases that are not done
+    bool reported = false;                 // whether finished() is emitted
+    QElapsedTimer timer;                   // measures the compilation time and the total time
+    qint64 compileTime = 0;                // the time used by the compilation (ms)
+    MessageLogger *log = nullptr;          // receives the messages of the checker, it's never shown
+    QStringList checkerMessages;           // the messages logged by the checker, added to the report
+    QTemporaryDir *tmpDir = nullptr;       // keeps the copy of the source file and the compiled program
+    Compiler *compiler = nullptr;
+    Checker *checker = nullptr;
+    QTimer *checkTimer = nullptr;
+    QVector<Runner *> runners;
+};
+} // namespace Core
+
+#endif // JUDGE_HPP
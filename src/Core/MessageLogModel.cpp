@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/MessageLogModel.hpp"
+#include "generated/SettingsHelper.hpp"
+#include <QTextDocumentFragment>
+
+const QString MessageLogModel::TOGGLE_ANCHOR = "#MessageLogger/Toggle";
+
+MessageLogModel::MessageLogModel(QObject *parent) : QAbstractListModel(parent)
+{
+}
+
+int MessageLogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : messages.count();
+}
+
+QVariant MessageLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= messages.count())
+        return QVariant();
+
+    const auto &message = messages[index.row()];
+    const bool collapsible = message.lineCount > COLLAPSED_LINE_COUNT;
+
+    switch (role)
+    {
+    case HtmlRole:
+        if (message.html.isEmpty())
+        {
+            // use monospace for the message body, it's important for compilation errors
+            // "monospace" might not work on Windows, but "Consolas,Courier,monospace" works
+            QString body = message.body;
+            if (collapsible && !message.expanded)
+                body = body.section('\n', 0, COLLAPSED_LINE_COUNT - 1);
+            message.html = QString("<b>[%1] [%2] </b><span style=\"").arg(message.time.toString(), message.head);
+            if (!message.color.isEmpty())
+                message.html += "color:" + message.color;
+            message.html += "\">[";
+            if (message.lineCount > 1)
+                message.html += "<br>" + body.replace("\n", "<br>");
+            else
+                message.html += body;
+            message.html += "]</span>";
+            if (collapsible)
+            {
+                message.html += QString("<br><a href=\"%1\">%2</a>")
+                                    .arg(TOGGLE_ANCHOR, message.expanded
+                                                            ? tr("Collapse")
+                                                            : tr("Show %n more line(s)", "",
+                                                                 message.lineCount - COLLAPSED_LINE_COUNT));
+            }
+        }
+        return message.html;
+    case Qt::DisplayRole:
+        if (message.plain.isEmpty())
+        {
+            QString body = message.body;
+            message.plain = QTextDocumentFragment::fromHtml(
+                                QString("[%1] [%2] [%3]")
+                                    .arg(message.time.toString(), message.head, body.replace("\n", "<br>")))
+                                .toPlainText();
+        }
+        return message.plain;
+    case IdRole:
+        return message.id;
+    case SourceRole:
+        return message.source;
+    case CollapsibleRole:
+        return collapsible;
+    default:
+        return QVariant();
+    }
+}
+
+quint64 MessageLogModel::append(QVector<Message> newMessages)
+{
+    const quint64 firstId = nextId;
+    nextId += newMessages.count();
+    if (newMessages.isEmpty())
+        return firstId;
+
+    // the messages that would be removed immediately are not inserted at all
+    const int limit = SettingsHelper::getMessageCountLimit();
+    int skipped = 0;
+    if (newMessages.count() > limit)
+    {
+        skipped = newMessages.count() - limit;
+        newMessages.remove(0, skipped);
+    }
+
+    if (messages.count() + newMessages.count() > limit)
+    {
+        const int removeCount = messages.count() + newMessages.count() - limit;
+        beginRemoveRows(QModelIndex(), 0, removeCount - 1);
+        messages.erase(messages.begin(), messages.begin() + removeCount);
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), messages.count(), messages.count() + newMessages.count() - 1);
+    for (int i = 0; i < newMessages.count(); ++i)
+    {
+        auto &message = newMessages[i];
+        message.id = firstId + skipped + i;
+        message.lineCount = message.body.count('\n') + 1;
+        message.html.clear();
+        message.plain.clear();
+        messages.push_back(message);
+    }
+    endInsertRows();
+
+    return firstId;
+}
+
+bool MessageLogModel::update(quint64 id, const QString &head, const QString &body)
+{
+    const int row = rowOf(id);
+    if (row == -1)
+        return false;
+    auto &message = messages[row];
+    message.head = head;
+    message.body = body;
+    message.lineCount = body.count('\n') + 1;
+    message.html.clear();
+    message.plain.clear();
+    emit dataChanged(index(row), index(row), {Qt::DisplayRole, HtmlRole, CollapsibleRole});
+    return true;
+}
+
+void MessageLogModel::toggleExpanded(int row)
+{
+    if (row < 0 || row >= messages.count())
+        return;
+    auto &message = messages[row];
+    message.expanded = !message.expanded;
+    message.html.clear();
+    emit dataChanged(index(row), index(row), {HtmlRole});
+}
+
+void MessageLogModel::clear()
+{
+    beginResetModel();
+    messages.clear();
+    endResetModel();
+}
+
+int MessageLogModel::rowOf(quint64 id) const
+{
+    if (messages.isEmpty() || id < messages.first().id || id > messages.last().id)
+        return -1;
+    return static_cast<int>(id - messages.first().id);
+}
+
+QString MessageLogModel::sourceOf(const QString &head)
+{
+    auto source = head.section('[', 0, 0).trimmed();
+    return source.isEmpty() ? head : source;
+}
+
+MessageLogFilterModel::MessageLogFilterModel(QObject *parent) : QSortFilterProxyModel(parent)
+{
+}
+
+bool MessageLogFilterModel::isSourceHidden(const QString &source) const
+{
+    return hiddenSources.contains(source);
+}
+
+void MessageLogFilterModel::setSourceHidden(const QString &source, bool hidden)
+{
+    if (hidden)
+        hiddenSources.insert(source);
+    else
+        hiddenSources.remove(source);
+    invalidateFilter();
+}
+
+void MessageLogFilterModel::showAllSources()
+{
+    hiddenSources.clear();
+    invalidateFilter();
+}
+
+bool MessageLogFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (hiddenSources.isEmpty())
+        return true;
+    return !hiddenSources.contains(
+        sourceModel()->index(sourceRow, 0, sourceParent).data(MessageLogModel::SourceRole).toString());
+}
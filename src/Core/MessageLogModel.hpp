@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+/*
+ * The MessageLogModel keeps the messages shown in a MessageLogger. It keeps at most "Message Count Limit" messages,
+ * and the oldest ones are removed when new messages arrive.
+ * The MessageLogFilterModel hides the messages from some of the sources.
+ */
+
+#ifndef MESSAGELOGMODEL_HPP
+#define MESSAGELOGMODEL_HPP
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QSet>
+#include <QSortFilterProxyModel>
+#include <QTime>
+#include <QVector>
+
+class MessageLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+  public:
+    struct Message
+    {
+        quint64 id = 0;        // unique in a model, used to identify a message when the rows are shifted
+        QTime time;            // when the message is shown
+        QString head;          // the head of the message, HTML
+        QString body;          // the body of the message, HTML, where '\n' is not converted to "<br>" yet
+        QString color;         // the color of the body, the default color if it's empty
+        QString source;        // the source of the message, used for filtering, e.g. "Runner" for "Runner[1]"
+        int lineCount = 1;     // the number of lines in the body
+        bool expanded = false; // whether a collapsible body is expanded
+        mutable QString html;  // the rendered HTML, empty if it's not rendered yet
+        mutable QString plain; // the plain text, empty if it's not rendered yet
+    };
+
+    enum Role
+    {
+        HtmlRole = Qt::UserRole, // the HTML of the message, rendered lazily
+        IdRole,                  // the id of the message
+        SourceRole,              // the source of the message
+        CollapsibleRole,         // whether the body is long enough to be collapsed
+    };
+
+    const static int COLLAPSED_LINE_COUNT = 12; // the number of lines shown when a long body is collapsed
+    static const QString TOGGLE_ANCHOR;         // the anchor which expands or collapses a long body
+
+    explicit MessageLogModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief append messages, and remove the oldest messages if there are too many
+     * @returns the id of the first appended message, the ids of the others follow it
+     * @note The ids of the messages are assigned here. The rows are inserted at once, so it's much faster than
+     * appending the messages one by one.
+     */
+    quint64 append(QVector<Message> newMessages);
+
+    /**
+     * @brief replace the head and the body of a message
+     * @returns false if the message is already removed
+     */
+    bool update(quint64 id, const QString &head, const QString &body);
+
+    /**
+     * @brief expand a collapsed body, or collapse an expanded body
+     */
+    void toggleExpanded(int row);
+
+    void clear();
+
+    /**
+     * @brief get the source of a message by its head, i.e. the part of the head before '['
+     */
+    static QString sourceOf(const QString &head);
+
+  private:
+    /**
+     * @brief get the row of a message, -1 if it's removed
+     * @note The ids in the model are consecutive, so this is O(1).
+     */
+    int rowOf(quint64 id) const;
+
+    QList<Message> messages;
+    quint64 nextId = 0;
+};
+
+class MessageLogFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+  public:
+    explicit MessageLogFilterModel(QObject *parent = nullptr);
+
+    bool isSourceHidden(const QString &source) const;
+    void setSourceHidden(const QString &source, bool hidden);
+    void showAllSources();
+
+  protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+  private:
+    QSet<QString> hiddenSources;
+};
+
+#endif // MESSAGELOGMODEL_HPP
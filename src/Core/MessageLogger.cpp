@@ -17,54 +17,175 @@
 
 #include "Core/MessageLogger.hpp"
 #include "Core/EventLogger.hpp"
+#include "Core/MessageLogModel.hpp"
 #include "Settings/PreferencesWindow.hpp"
 #include "generated/SettingsHelper.hpp"
-#include <QDateTime>
+#include <QAbstractTextDocumentLayout>
+#include <QApplication>
+#include <QClipboard>
+#include <QContextMenuEvent>
+#include <QDesktopServices>
+#include <QMenu>
+#include <QPainter>
+#include <QScrollBar>
+#include <QStyledItemDelegate>
+#include <QTextDocument>
+#include <QTimer>
+#include <QtMath>
 
-MessageLogger::MessageLogger(PreferencesWindow *preferences, QWidget *parent)
-    : QTextBrowser(parent), preferencesWindow(preferences)
+/*
+ * Renders the HTML of a message. The documents are created only for the rows being painted or measured,
+ * and the sizes are cached until the width or the font changes.
+ */
+class MessageLogDelegate : public QStyledItemDelegate
 {
-    connect(this, &MessageLogger::anchorClicked, this, &MessageLogger::onAnchorClicked);
-    setOpenExternalLinks(true);
-}
+  public:
+    explicit MessageLogDelegate(QListView *view) : QStyledItemDelegate(view), view(view)
+    {
+    }
 
-void MessageLogger::message(const QString &head, const QString &body, const QString &color, bool htmlEscaped)
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override
+    {
+        QStyleOptionViewItem opt = option;
+        initStyleOption(&opt, index);
+        opt.text.clear();
+        auto *style = opt.widget ? opt.widget->style() : QApplication::style();
+        style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, opt.widget);
+
+        QTextDocument document;
+        prepare(document, index);
+
+        QAbstractTextDocumentLayout::PaintContext context;
+        context.palette = option.palette;
+        if (option.state & QStyle::State_Selected)
+            context.palette.setColor(QPalette::Text, option.palette.color(QPalette::HighlightedText));
+        context.clip = QRectF(0, 0, option.rect.width(), option.rect.height());
+
+        painter->save();
+        painter->translate(option.rect.topLeft());
+        painter->setClipRect(context.clip);
+        document.documentLayout()->draw(painter, context);
+        painter->restore();
+    }
+
+    QSize sizeHint(const QStyleOptionViewItem & /*option*/, const QModelIndex &index) const override
+    {
+        const auto id = index.data(MessageLogModel::IdRole).toULongLong();
+        auto it = sizeCache.constFind(id);
+        if (it != sizeCache.constEnd())
+            return *it;
+
+        QTextDocument document;
+        prepare(document, index);
+        // the lines are not wrapped at "&nbsp;", so the item can be wider than the viewport
+        QSize size(qCeil(qMax(document.idealWidth(), document.textWidth())), qCeil(document.size().height()));
+        sizeCache.insert(id, size);
+        return size;
+    }
+
+    /**
+     * @brief get the anchor at a position relative to the top-left corner of the item
+     */
+    QString anchorAt(const QModelIndex &index, const QPoint &pos) const
+    {
+        QTextDocument document;
+        prepare(document, index);
+        return document.documentLayout()->anchorAt(pos);
+    }
+
+    void forget(quint64 id)
+    {
+        sizeCache.remove(id);
+    }
+
+    void forgetAll()
+    {
+        sizeCache.clear();
+    }
+
+  private:
+    void prepare(QTextDocument &document, const QModelIndex &index) const
+    {
+        document.setDefaultFont(view->font());
+        document.setDocumentMargin(2);
+        document.setTextWidth(view->viewport()->width());
+        document.setHtml(index.data(MessageLogModel::HtmlRole).toString());
+    }
+
+    QListView *view;
+    mutable QHash<quint64, QSize> sizeCache; // the size hints of the messages, by their ids
+};
+
+static MessageLogModel::Message makeMessage(const QString &head, const QString &body, const QString &color,
+                                            bool htmlEscaped)
 {
     LOG_WARN_IF(body.contains("<a href") && htmlEscaped,
                 "The message contains \"<a href\", but htmlEscaped is enabled.");
 
-    QString newHead;
-    QString newBody;
+    MessageLogModel::Message message;
+    message.time = QTime::currentTime();
+    message.color = color;
+    message.source = MessageLogModel::sourceOf(head);
     if (htmlEscaped)
     {
         // replace spaces by "&nbsp;" to avoid multiple spaces becoming one, important for compilation errors
-        newHead = head.toHtmlEscaped().replace(" ", "&nbsp;");
-        newBody = body.toHtmlEscaped().replace(" ", "&nbsp;");
+        message.head = head.toHtmlEscaped().replace(" ", "&nbsp;");
+        message.body = body.toHtmlEscaped().replace(" ", "&nbsp;");
     }
     else
     {
-        newHead = head;
-        newBody = body;
+        message.head = head;
+        message.body = body;
     }
 
-    // don't display too long messages, otherwise the application may stuck
-    if (newBody.length() > SettingsHelper::getMessageLengthLimit())
-        newBody = newBody.left(SettingsHelper::getMessageLengthLimit()) + tr("\n... The message is too long");
+    // don't keep too long messages, otherwise the memory usage is not bounded
+    if (message.body.length() > SettingsHelper::getMessageLengthLimit())
+        message.body = message.body.left(SettingsHelper::getMessageLengthLimit()) +
+                       MessageLogger::tr("\n... The message is too long");
 
-    // get the HTML of the message
-    // use monospace for the message body, it's important for compilation errors
-    // "monospace" might not work on Windows, but "Consolas,Courier,monospace" works
-    QString res = QString("<b>[%1] [%2] </b><span style=\"").arg(QTime::currentTime().toString(), newHead);
-    if (!color.isEmpty())
-        res += "color:" + color;
-    res += "\">[";
-    if (newBody.contains('\n'))
-        res += "<br>" + newBody.replace("\n", "<br>");
-    else
-        res += newBody;
-    res += "]</span>";
+    return message;
+}
+
+MessageLogger::MessageLogger(PreferencesWindow *preferences, QWidget *parent)
+    : QListView(parent), preferencesWindow(preferences), model(new MessageLogModel(this)),
+      filterModel(new MessageLogFilterModel(this)), delegate(new MessageLogDelegate(this)), flushTimer(new QTimer(this))
+{
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(FLUSH_INTERVAL);
+    connect(flushTimer, &QTimer::timeout, this, &MessageLogger::flush);
+
+    filterModel->setSourceModel(model);
+    setModel(filterModel);
+    setItemDelegate(delegate);
 
-    append(res);
+    // only the visible rows are rendered, and the sizes of the others are measured in batches
+    setUniformItemSizes(false);
+    setLayoutMode(QListView::Batched);
+    setBatchSize(50);
+    setResizeMode(QListView::Adjust);
+    setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
+    setSelectionMode(QAbstractItemView::ExtendedSelection);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setMouseTracking(true);
+
+    connect(model, &MessageLogModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &, int first, int last) {
+        for (int i = first; i <= last; ++i)
+            delegate->forget(model->index(i).data(MessageLogModel::IdRole).toULongLong());
+    });
+    connect(model, &MessageLogModel::modelAboutToBeReset, this, [this] { delegate->forgetAll(); });
+    connect(model, &MessageLogModel::dataChanged, this,
+            [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+                for (int i = topLeft.row(); i <= bottomRight.row(); ++i)
+                    delegate->forget(model->index(i).data(MessageLogModel::IdRole).toULongLong());
+                scheduleDelayedItemsLayout();
+            });
+}
+
+void MessageLogger::message(const QString &head, const QString &body, const QString &color, bool htmlEscaped)
+{
+    emit messageLogged(head, body);
+    enqueue(makeMessage(head, body, color, htmlEscaped));
 }
 
 void MessageLogger::info(const QString &head, const QString &body, bool htmlEscaped)
@@ -85,10 +206,201 @@ void MessageLogger::error(const QString &head, const QString &body, bool htmlEsc
     message(head, body, SettingsHelper::getErrorMessageColor(), htmlEscaped);
 }
 
+void MessageLogger::groupedInfo(const QString &group, const QString &head, const QString &body, qint64 value,
+                                const std::function<QString(int, qint64, qint64)> &summary)
+{
+    LOG_INFO(INFO_OF(group) << INFO_OF(head) << INFO_OF(body));
+
+    auto &state = groups[group];
+    if (state.count == 0)
+    {
+        state.head = head;
+        state.body = body;
+        state.summaryHead = MessageLogModel::sourceOf(head);
+        state.summary = summary;
+        state.min = state.max = value;
+    }
+    ++state.count;
+    state.min = qMin(state.min, value);
+    state.max = qMax(state.max, value);
+
+    // the head and the body are decided when it's flushed
+    if (!state.queued)
+    {
+        state.queued = true;
+        auto message = makeMessage(head, QString(), QString(), true);
+        pendingMessages.push_back(message);
+        pendingGroups.push_back(group);
+        if (!sources.contains(message.source))
+            sources.push_back(message.source);
+        if (!flushTimer->isActive())
+            flushTimer->start();
+    }
+}
+
+void MessageLogger::clear()
+{
+    pendingMessages.clear();
+    pendingGroups.clear();
+    groups.clear();
+    flushTimer->stop();
+    model->clear();
+}
+
+void MessageLogger::enqueue(MessageLogModel::Message message)
+{
+    if (!sources.contains(message.source))
+        sources.push_back(message.source);
+    pendingMessages.push_back(message);
+    pendingGroups.push_back(QString());
+    if (!flushTimer->isActive())
+        flushTimer->start();
+}
+
+void MessageLogger::flush()
+{
+    QVector<MessageLogModel::Message> newMessages;
+    QVector<QPair<QString, int>> newGroupMessages; // the groups shown for the first time, and their positions
+
+    for (int i = 0; i < pendingMessages.count(); ++i)
+    {
+        auto &message = pendingMessages[i];
+        const auto &group = pendingGroups[i];
+        if (!group.isEmpty())
+        {
+            auto &state = groups[group];
+            state.queued = false;
+            const auto groupMessage =
+                state.count == 1 ? makeMessage(state.head, state.body, QString(), true)
+                                 : makeMessage(state.summaryHead, state.summary(state.count, state.min, state.max),
+                                               QString(), true);
+            if (state.shown && model->update(state.id, groupMessage.head, groupMessage.body))
+                continue;
+            message.head = groupMessage.head;
+            message.body = groupMessage.body;
+            newGroupMessages.push_back({group, newMessages.count()});
+        }
+        newMessages.push_back(message);
+    }
+    pendingMessages.clear();
+    pendingGroups.clear();
+
+    const bool atBottom = verticalScrollBar()->value() == verticalScrollBar()->maximum();
+
+    const auto firstId = model->append(newMessages);
+    for (const auto &groupMessage : qAsConst(newGroupMessages))
+    {
+        auto &state = groups[groupMessage.first];
+        state.id = firstId + groupMessage.second;
+        state.shown = true;
+    }
+
+    if (atBottom)
+        scrollToBottom();
+}
+
+void MessageLogger::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::FontChange)
+    {
+        delegate->forgetAll();
+        scheduleDelayedItemsLayout();
+    }
+    QListView::changeEvent(event);
+}
+
+void MessageLogger::contextMenuEvent(QContextMenuEvent *event)
+{
+    QMenu menu;
+
+    auto *copyAction = menu.addAction(tr("Copy"), this, &MessageLogger::copySelected);
+    copyAction->setEnabled(selectionModel()->hasSelection());
+    menu.addAction(tr("Select All"), this, &MessageLogger::selectAll);
+    menu.addAction(tr("Clear"), this, &MessageLogger::clear);
+
+    if (!sources.isEmpty())
+    {
+        menu.addSeparator();
+        auto *sourceMenu = menu.addMenu(tr("Show Messages From"));
+        for (const auto &source : qAsConst(sources))
+        {
+            auto *action = sourceMenu->addAction(source);
+            action->setCheckable(true);
+            action->setChecked(!filterModel->isSourceHidden(source));
+            connect(action, &QAction::toggled, this,
+                    [this, source](bool checked) { filterModel->setSourceHidden(source, !checked); });
+        }
+        sourceMenu->addSeparator();
+        sourceMenu->addAction(tr("Show All"), filterModel, &MessageLogFilterModel::showAllSources);
+    }
+
+    menu.exec(event->globalPos());
+}
+
+void MessageLogger::keyPressEvent(QKeyEvent *event)
+{
+    if (event->matches(QKeySequence::Copy))
+        copySelected();
+    else
+        QListView::keyPressEvent(event);
+}
+
+void MessageLogger::mouseMoveEvent(QMouseEvent *event)
+{
+    viewport()->setCursor(anchorAt(event->pos()).isEmpty() ? Qt::ArrowCursor : Qt::PointingHandCursor);
+    QListView::mouseMoveEvent(event);
+}
+
+void MessageLogger::mouseReleaseEvent(QMouseEvent *event)
+{
+    const auto anchor = event->button() == Qt::LeftButton ? anchorAt(event->pos()) : QString();
+    if (anchor.isEmpty())
+    {
+        QListView::mouseReleaseEvent(event);
+    }
+    else if (anchor == MessageLogModel::TOGGLE_ANCHOR)
+    {
+        model->toggleExpanded(filterModel->mapToSource(indexAt(event->pos())).row());
+    }
+    else
+    {
+        onAnchorClicked(QUrl(anchor));
+    }
+}
+
+void MessageLogger::resizeEvent(QResizeEvent *event)
+{
+    if (event->size().width() != event->oldSize().width())
+        delegate->forgetAll();
+    QListView::resizeEvent(event);
+}
+
+QString MessageLogger::anchorAt(const QPoint &pos) const
+{
+    const auto index = indexAt(pos);
+    if (!index.isValid())
+        return QString();
+    return delegate->anchorAt(index, pos - visualRect(index).topLeft());
+}
+
+void MessageLogger::copySelected()
+{
+    auto rows = selectionModel()->selectedRows();
+    if (rows.isEmpty())
+        return;
+    std::sort(rows.begin(), rows.end());
+    QStringList lines;
+    for (const auto &index : qAsConst(rows))
+        lines.push_back(index.data(Qt::DisplayRole).toString());
+    QApplication::clipboard()->setText(lines.join('\n'));
+}
+
 void MessageLogger::onAnchorClicked(const QUrl &link)
 {
     auto url = link.toString();
     LOG_INFO(INFO_OF(url));
     if (url.startsWith("#Preferences/"))
         preferencesWindow->open(url.mid(13));
+    else
+        QDesktopServices::openUrl(link);
 }
@@ -17,16 +17,24 @@
 
 /*
  * The MessageLogger is used to send messages to the user directly in the GUI.
+ * The messages are kept in a MessageLogModel, and only the visible ones are rendered.
+ * New messages are queued and flushed to the model at most once per frame, and the messages in the same group are
+ * merged into a summary, so that running many test cases at once doesn't block the UI.
  */
 
 #ifndef MESSAGELOGGER_HPP
 #define MESSAGELOGGER_HPP
 
-#include <QTextBrowser>
+#include "Core/MessageLogModel.hpp"
+#include <QHash>
+#include <QListView>
+#include <functional>
 
+class MessageLogDelegate;
 class PreferencesWindow;
+class QTimer;
 
-class MessageLogger : public QTextBrowser
+class MessageLogger : public QListView
 {
     Q_OBJECT
 
@@ -69,11 +77,84 @@ class MessageLogger : public QTextBrowser
      */
     void error(const QString &head, const QString &body, bool htmlEscaped = true);
 
+    /**
+     * @brief show an information message which is merged with the other messages in the same group
+     * @param group the messages in the same group are shown as one message until the logger is cleared
+     * @param head the head of the message
+     * @param body the body of the message when it's the only message in the group
+     * @param value a number recorded for the summary, e.g. the time used
+     * @param summary returns the body when there are multiple messages in the group, the parameters are the number
+     * of messages and the minimum and maximum of the values
+     * @note The head of the summary is the source of the head, e.g. "Runner" for "Runner[1]".
+     */
+    void groupedInfo(const QString &group, const QString &head, const QString &body, qint64 value,
+                     const std::function<QString(int, qint64, qint64)> &summary);
+
+    /**
+     * @brief remove all messages
+     * @note The hidden sources are kept.
+     */
+    void clear();
+
+  signals:
+    /**
+     * @brief a message is logged by message(), info(), warn() or error()
+     * @param head the head of the message, not escaped
+     * @param body the body of the message, not escaped
+     * @note It's emitted immediately, before the message is flushed to the model.
+     */
+    void messageLogged(const QString &head, const QString &body);
+
+  protected:
+    void changeEvent(QEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
   private slots:
     void onAnchorClicked(const QUrl &link);
 
   private:
+    /**
+     * @brief get the anchor under a position in the viewport, an empty string if there's no anchor
+     */
+    QString anchorAt(const QPoint &pos) const;
+
+    void copySelected();
+
+    /**
+     * @brief add the queued messages to the model and update the groups
+     */
+    void flush();
+
+    void enqueue(MessageLogModel::Message message);
+
+    struct Group
+    {
+        int count = 0;                                       // the number of messages in the group
+        qint64 min = 0, max = 0;                             // the range of the values
+        QString head;                                        // the head of the first message
+        QString body;                                        // the body of the first message
+        QString summaryHead;                                 // the head of the summary
+        std::function<QString(int, qint64, qint64)> summary; // generates the summary body
+        quint64 id = 0;                                      // the id of the message in the model
+        bool shown = false;                                  // whether the message is added to the model
+        bool queued = false;                                 // whether the message is in pendingMessages
+    };
+
+    const static int FLUSH_INTERVAL = 16; // the interval between two flushes (ms), about once per frame
+
     PreferencesWindow *preferencesWindow = nullptr;
+    MessageLogModel *model = nullptr;
+    MessageLogFilterModel *filterModel = nullptr;
+    MessageLogDelegate *delegate = nullptr;
+    QStringList sources; // the sources of the messages ever shown, in the order of their first messages
+    QVector<MessageLogModel::Message> pendingMessages; // the messages not flushed yet
+    QVector<QString> pendingGroups;                    // the group of each pending message, empty if it's not grouped
+    QHash<QString, Group> groups;                      // the groups since the last clear()
+    QTimer *flushTimer = nullptr;
 };
 
 #endif // MESSAGELOGGER_HPP
@@ -21,6 +21,7 @@
 #include "Util/FileUtil.hpp"
 #include <QElapsedTimer>
 #include <QFileInfo>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QTimer>
 #include <generated/SettingsHelper.hpp>
@@ -53,9 +54,37 @@ Runner::~Runner()
         delete runProcess;
     }
 
+    if (interactorProcess != nullptr)
+    {
+        if (interactorProcess->state() == QProcess::Running)
+        {
+            LOG_WARN("The interactor of Runner at index:" << runnerIndex << " was running and forcefully killed");
+            interactorProcess->kill();
+        }
+        delete interactorProcess;
+    }
+
+    delete interactionDir;
+    delete scratchDir;
     delete runTimer;
 }
 
+void Runner::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    // the names may come from a parsed problem, they must not point to a file outside the scratch directory
+    invalidFileIO = (!inputFileName.isEmpty() && !Util::isPlainFileName(inputFileName)) ||
+                    (!outputFileName.isEmpty() && !Util::isPlainFileName(outputFileName));
+    if (invalidFileIO)
+    {
+        LOG_WARN("Invalid file I/O names " << INFO_OF(inputFileName) << INFO_OF(outputFileName));
+        fileIOInput.clear();
+        fileIOOutput.clear();
+        return;
+    }
+    fileIOInput = inputFileName;
+    fileIOOutput = outputFileName;
+}
+
 void Runner::run(const QString &tmpFilePath, const QString &sourceFilePath, const QString &lang,
                  const QString &runCommand, const QString &args, const QString &input, int timeLimit)
 {
@@ -70,6 +99,12 @@ void Runner::run(const QString &tmpFilePath, const QString &sourceFilePath, cons
         return;
     }
 
+    if (invalidFileIO)
+    {
+        emit failedToStartRun(runnerIndex, tr("The names of the input and output files are invalid."));
+        return;
+    }
+
     // get the command for execution
     QStringList command = QProcess::splitCommand(getCommand(tmpFilePath, sourceFilePath, lang, runCommand, args));
     if (command.isEmpty())
@@ -94,9 +129,26 @@ void Runner::run(const QString &tmpFilePath, const QString &sourceFilePath, cons
         emit failedToStartRun(runnerIndex, tr("Failed to create temporary file."));
         return;
     }
-    Util::saveFile(inputFile->fileName(), input, "Runner Input", false);
+    Util::saveFile(inputFile->fileName(), input, "Runner Input", false, nullptr, false, Util::FileKind::Temp);
     runProcess->setStandardInputFile(inputFile->fileName());
 
+    if (!fileIOInput.isEmpty() || !fileIOOutput.isEmpty())
+    {
+        // each run gets its own directory, so that the tests running in parallel don't clobber each other's files
+        scratchDir = new QTemporaryDir();
+        if (!scratchDir->isValid())
+        {
+            emit failedToStartRun(runnerIndex, tr("Failed to create temporary directory."));
+            return;
+        }
+        if (!fileIOInput.isEmpty() && !Util::linkOrCopyFile(inputFile->fileName(), scratchDir->filePath(fileIOInput)))
+        {
+            emit failedToStartRun(runnerIndex, tr("Failed to create the input file %1.").arg(fileIOInput));
+            return;
+        }
+        runProcess->setWorkingDirectory(scratchDir->path());
+    }
+
     killTimer = new QTimer(runProcess);
     killTimer->setSingleShot(true);
     killTimer->setInterval(timeLimit);
@@ -149,11 +201,120 @@ void Runner::runDetached(const QString &tmpFilePath, const QString &sourceFilePa
 #endif
 }
 
+void Runner::runInteractive(const QString &tmpFilePath, const QString &sourceFilePath, const QString &lang,
+                            const QString &runCommand, const QString &args, const QString &interactorPath,
+                            const QString &input, const QString &expected, int timeLimit)
+{
+    LOG_INFO(INFO_OF(tmpFilePath) << INFO_OF(sourceFilePath) << INFO_OF(lang) << INFO_OF(runCommand) << INFO_OF(args)
+                                  << INFO_OF(interactorPath) << INFO_OF(timeLimit));
+
+    isDetachedRun = false;
+
+    if (!QFile::exists(tmpFilePath)) // make sure the source file exists, this usually means the executable file exists
+    {
+        emit failedToStartRun(runnerIndex, tr("The source file %1 doesn't exist.").arg(tmpFilePath));
+        return;
+    }
+
+    QStringList command = QProcess::splitCommand(getCommand(tmpFilePath, sourceFilePath, lang, runCommand, args));
+    if (command.isEmpty())
+    {
+        emit failedToStartRun(runnerIndex, tr("Failed to get run command. It's probably a bug."));
+        return;
+    }
+
+    // save the files of the interactor, the output file is written by the interactor itself
+
+    interactionDir = new QTemporaryDir();
+    if (!interactionDir->isValid())
+    {
+        emit failedToStartRun(runnerIndex, tr("Failed to create temporary directory."));
+        return;
+    }
+
+    const auto inputPath = interactionDir->filePath("input.txt");
+    const auto outputPath = interactionDir->filePath("output.txt");
+    const auto answerPath = interactionDir->filePath("answer.txt");
+    if (!Util::saveFile(inputPath, input, "Runner Input", false, nullptr, false, Util::FileKind::Temp) ||
+        !Util::saveFile(answerPath, expected, "Runner Answer", false, nullptr, false, Util::FileKind::Temp))
+    {
+        emit failedToStartRun(runnerIndex, tr("Failed to save the files of the interactor."));
+        return;
+    }
+
+    const auto interactorArgs = QString("\"%1\" \"%2\" \"%3\"").arg(inputPath, outputPath, answerPath);
+    QStringList interactorCommand = QProcess::splitCommand(getCommand(interactorPath, "", "C++", "", interactorArgs));
+
+    // connect signals and set timers
+
+    interactorProcess = new QProcess();
+    interactorProcess->setWorkingDirectory(interactionDir->path());
+    connect(interactorProcess, qOverload<int, QProcess::ExitStatus>(&QProcess::finished), this,
+            &Runner::onInteractorFinished);
+    connect(interactorProcess, &QProcess::readyReadStandardError, this, &Runner::onReadyReadInteractorError);
+    connect(interactorProcess, &QProcess::errorOccurred, this, &Runner::onInteractorErrorOccurred);
+
+    connect(runProcess, qOverload<int, QProcess::ExitStatus>(&QProcess::finished), this, &Runner::onFinished);
+    connect(runProcess, &QProcess::readyReadStandardError, this, &Runner::onReadyReadStandardError);
+
+    // Cross-connect the two processes. The pipes are created by the OS when the processes start, so the messages
+    // between them never go through the event loop of this process, no matter how many queries there are.
+    runProcess->setStandardOutputProcess(interactorProcess);
+    interactorProcess->setStandardOutputProcess(runProcess);
+
+    setWorkingDirectory(tmpFilePath, sourceFilePath, lang);
+
+    killTimer = new QTimer(runProcess);
+    killTimer->setSingleShot(true);
+    killTimer->setInterval(timeLimit);
+    connect(killTimer, &QTimer::timeout, this, &Runner::onTimeout);
+
+    runTimer = new QElapsedTimer();
+
+    killTimer->start();
+
+    QString interactorProgram = interactorCommand.takeFirst();
+    interactorProcess->start(interactorProgram, interactorCommand);
+
+    QString program = command.takeFirst();
+    runProcess->start(program, command);
+}
+
 void Runner::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
     const auto timeUsed = runTimer->isValid() ? runTimer->elapsed() : 0;
-    emit runFinished(runnerIndex, processStdout + runProcess->readAllStandardOutput(),
-                     processStderr + runProcess->readAllStandardError(), exitCode, timeUsed, timeLimitExceeded);
+
+    if (interactorProcess != nullptr)
+    {
+        // the interactor may be still running, report both results when both processes are finished
+        processStderr.append(runProcess->readAllStandardError());
+        processExitCode = exitCode;
+        processTimeUsed = timeUsed;
+        isProcessFinished = true;
+        emitInteractiveResultIfFinished();
+        return;
+    }
+
+    QString out = processStdout + runProcess->readAllStandardOutput();
+
+    if (!fileIOOutput.isEmpty() && scratchDir != nullptr)
+    {
+        QFile outputFile(scratchDir->filePath(fileIOOutput));
+        if (outputFile.open(QIODevice::ReadOnly | QIODevice::Text))
+        {
+            // read at most one more byte than the limit, the rest is not shown anyway
+            const auto limit = SettingsHelper::getOutputLengthLimit();
+            out = outputFile.read(limit + 1).replace('\0', "");
+            if (out.length() > limit && !outputLimitExceededEmitted)
+            {
+                outputLimitExceededEmitted = true;
+                emit runOutputLimitExceeded(runnerIndex, fileIOOutput);
+            }
+        }
+    }
+
+    emit runFinished(runnerIndex, out, processStderr + runProcess->readAllStandardError(), exitCode, timeUsed,
+                     timeLimitExceeded);
 }
 
 void Runner::onStarted()
@@ -171,6 +332,12 @@ void Runner::onTimeout()
         timeLimitExceeded = true;
         runProcess->kill();
     }
+    if (interactorProcess != nullptr && interactorProcess->state() == QProcess::Running)
+    {
+        LOG_INFO("Interactor was running, and forcefully killed it because time limit was reached");
+        interactorTimeLimitExceeded = true;
+        interactorProcess->kill();
+    }
 }
 
 void Runner::onReadyReadStandardOutput()
@@ -212,9 +379,56 @@ void Runner::onErrorOccurred(QProcess::ProcessError error)
         {
             emit failedToStartRun(runnerIndex, tr("Failed to start running. Please compile first."));
         }
+
+        if (interactorProcess != nullptr)
+        {
+            // the result of the interactor is meaningless without the program
+            disconnect(interactorProcess, nullptr, this, nullptr);
+            interactorProcess->kill();
+        }
+    }
+}
+
+void Runner::onInteractorFinished(int exitCode)
+{
+    interactorStderr.append(interactorProcess->readAllStandardError().replace('\0', ""));
+    interactorStderr.truncate(SettingsHelper::getOutputLengthLimit());
+    interactorExitCode = exitCode;
+    interactorTimeUsed = runTimer->isValid() ? runTimer->elapsed() : 0;
+    isInteractorFinished = true;
+    emitInteractiveResultIfFinished();
+}
+
+void Runner::onReadyReadInteractorError()
+{
+    const int limit = SettingsHelper::getOutputLengthLimit();
+    const auto err = interactorProcess->readAllStandardError().replace('\0', "");
+    if (interactorStderr.length() < limit)
+        interactorStderr.append(err.left(limit - interactorStderr.length()));
+}
+
+void Runner::onInteractorErrorOccurred(QProcess::ProcessError error)
+{
+    if (error == QProcess::FailedToStart)
+    {
+        emit failedToStartRun(runnerIndex, tr("Failed to start the interactor. Please check the interactor."));
+        // the program can't finish the interaction without the interactor
+        disconnect(runProcess, nullptr, this, nullptr);
+        runProcess->kill();
     }
 }
 
+void Runner::emitInteractiveResultIfFinished()
+{
+    if (!isProcessFinished || !isInteractorFinished)
+        return;
+
+    const auto out = Util::readFile(interactionDir->filePath("output.txt"), "Runner Interactor Output");
+    emit interactorFinished(runnerIndex, out, interactorStderr, interactorExitCode, interactorTimeUsed,
+                            interactorTimeLimitExceeded);
+    emit runFinished(runnerIndex, out, processStderr, processExitCode, processTimeUsed, timeLimitExceeded);
+}
+
 QString Runner::getCommand(const QString &tmpFilePath, const QString &sourceFilePath, const QString &lang,
                            const QString &runCommand, const QString &args)
 {
@@ -28,6 +28,7 @@
 #include <QProcess>
 
 class QElapsedTimer;
+class QTemporaryDir;
 class QTemporaryFile;
 class QTimer;
 
@@ -51,6 +52,17 @@ class Runner : public QObject
      */
     ~Runner() override;
 
+    /**
+     * @brief use files instead of stdin and stdout in run()
+     * @param inputFileName the name of the input file the program reads, empty if it only reads stdin
+     * @param outputFileName the name of the output file the program writes, empty if it only writes stdout
+     * @note If any of them is set, the program runs in a new temporary directory, so that the runs in parallel don't
+     *       clobber each other's files. The input is still available on stdin, and the output file replaces stdout
+     *       in runFinished if the program creates it. This should be called before run().
+     *       A name that is not a plain file name (see Util::isPlainFileName) makes run() fail to start.
+     */
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+
     /**
      * @brief run a program on a given input
      * @param tmpFilePath the path to the temporary file which is compiled
@@ -77,6 +89,26 @@ class Runner : public QObject
     void runDetached(const QString &tmpFilePath, const QString &sourceFilePath, const QString &lang,
                      const QString &runCommand, const QString &args);
 
+    /**
+     * @brief run a program interactively with a testlib interactor
+     * @param tmpFilePath the path to the temporary file which is compiled
+     * @param sourceFilePath the path to the original source file
+     * @param lang the language to run, one of "C++", "Java" and "Python"
+     * @param runCommand the command for running a program
+     * @param args the command line arguments added at the back to start the program
+     * @param interactorPath the path to the compiled C++ source of the interactor
+     * @param input the input file passed to the interactor
+     * @param expected the answer file passed to the interactor
+     * @param timeLimit the maximum time for both processes to run, in milliseconds
+     * @note The stdout of each process is piped to the stdin of the other one by the OS, the data never goes through
+     *       this process. The interactor is started as "interactor <input> <output> <answer>", interactorFinished
+     *       is emitted right before runFinished, and the out of both signals is the output file of the interactor.
+     *       This should be called only once. Please create multiple Runners for multiple runs.
+     */
+    void runInteractive(const QString &tmpFilePath, const QString &sourceFilePath, const QString &lang,
+                        const QString &runCommand, const QString &args, const QString &interactorPath,
+                        const QString &input, const QString &expected, int timeLimit);
+
   signals:
     /**
      * @brief the execution has just started
@@ -95,6 +127,19 @@ class Runner : public QObject
      */
     void runFinished(int index, const QString &out, const QString &err, int exitCode, qint64 timeUsed, bool tle);
 
+    /**
+     * @brief the interactor of an interactive execution has finished
+     * @param index the index of the testcase
+     * @param out the output file of the interactor
+     * @param err the stderr of the interactor
+     * @param exitCode the exit code of the interactor
+     * @param timeUsed the time between the execution started and the interactor finished
+     * @param tle whether the interactor was killed because the time limit is exceeded
+     * @note this is only emitted by runInteractive, after both processes are finished
+     */
+    void interactorFinished(int index, const QString &out, const QString &err, int exitCode, qint64 timeUsed,
+                            bool tle);
+
     /**
      * @brief failed to start the execution
      * @param index the index of the testcase
@@ -153,7 +198,29 @@ class Runner : public QObject
      */
     void onErrorOccurred(QProcess::ProcessError error);
 
+    /**
+     * @brief the interactor is finished
+     * @param exitCode the exit code of the interactor
+     */
+    void onInteractorFinished(int exitCode);
+
+    /**
+     * @brief the stderr of the interactor updated
+     * @note the stderr is truncated at the output length limit instead of killing the interactor
+     */
+    void onReadyReadInteractorError();
+
+    /**
+     * @brief if the error is FailedToStart, kill the program and emit failedToStartRun
+     */
+    void onInteractorErrorOccurred(QProcess::ProcessError error);
+
   private:
+    /**
+     * @brief emit interactorFinished and runFinished if both processes are finished
+     */
+    void emitInteractiveResultIfFinished();
+
     /**
      * @brief get the command to run a program
      * @param tmpFilePath the path to the temporary file which is compiled
@@ -182,6 +249,21 @@ class Runner : public QObject
     bool outputLimitExceededEmitted = false; // whether runOutputLimitExceeded is emitted or not
     bool timeLimitExceeded = false;
     bool isDetachedRun = false;
+    QString fileIOInput;                     // the name of the input file, empty for stdin only
+    QString fileIOOutput;                    // the name of the output file, empty for stdout only
+    bool invalidFileIO = false;              // whether the file names given to setFileIO() are rejected
+    QTemporaryDir *scratchDir = nullptr;     // the working directory of a run with file I/O
+
+    QProcess *interactorProcess = nullptr;   // the interactor in an interactive execution, null otherwise
+    QTemporaryDir *interactionDir = nullptr; // the input, output and answer files of the interactor
+    QByteArray interactorStderr;             // the stderr of the interactor
+    bool interactorTimeLimitExceeded = false;
+    bool isProcessFinished = false;          // whether the program of the interactive execution is finished
+    bool isInteractorFinished = false;       // whether the interactor of the interactive execution is finished
+    int processExitCode = 0;                 // the exit code of the program, saved until both are finished
+    int interactorExitCode = 0;              // the exit code of the interactor, saved until both are finished
+    qint64 processTimeUsed = 0;              // the time used by the program
+    qint64 interactorTimeUsed = 0;           // the time used by the interactor
 };
 
 } // namespace Core
@@ -18,15 +18,23 @@
 #include "Core/SessionManager.hpp"
 #include "../../ui/ui_appwindow.h"
 #include "Core/EventLogger.hpp"
+#include "Core/StartupTracer.hpp"
 #include "Util/FileUtil.hpp"
+#include "Util/FunctionRunnable.hpp"
+#include "Widgets/TabPlaceholder.hpp"
 #include "appwindow.hpp"
 #include "generated/portable.hpp"
 #include "mainwindow.hpp"
+#include <QCryptographicHash>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QProgressDialog>
+#include <QSaveFile>
+#include <QSignalBlocker>
+#include <QThreadPool>
 #include <QTimer>
 
 namespace Core
@@ -37,16 +45,50 @@ const static QStringList sessionFileLocations = {
 #endif
     "$APPCONFIG/session.json", "$OLDAPPCONFIG/cp_editor_session.json"};
 
+// the keys of the texts saved in blobs, and the keys of the blob hashes in the manifest
+const static QStringList blobTextKeys = {"editorText", "savedText"};
+const static QStringList blobListKeys = {"input", "expected"};
+const static QString blobKeySuffix = "Blob";
+
+static QString blobDirectoryPath(const QString &sessionPath)
+{
+    const QFileInfo info(sessionPath);
+    return info.dir().filePath(info.completeBaseName() + "_blobs");
+}
+
+static QString readBlob(const QDir &blobDirectory, const QString &hash)
+{
+    if (hash.isEmpty())
+        return "";
+    QFile file(blobDirectory.filePath(hash));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        LOG_ERR("Failed to read the session blob [" << file.fileName() << "]");
+        return "";
+    }
+    return QString::fromUtf8(file.readAll());
+}
+
 SessionManager::SessionManager(AppWindow *appwindow) : QObject(appwindow), app(appwindow)
 {
     timer = new QTimer(this);
 
     timer->setInterval(10000);
     connect(timer, &QTimer::timeout, this, &SessionManager::updateSession, Qt::DirectConnection);
+
+    writerPool = new QThreadPool(this);
+    writerPool->setMaxThreadCount(1);
+}
+
+SessionManager::~SessionManager()
+{
+    // writeSession() uses the members, so it must finish before they are destructed
+    writerPool->waitForDone();
 }
 
 void SessionManager::restoreSession(const QString &path)
 {
+    TRACE_STARTUP("SessionManager::restoreSession");
     LOG_INFO(INFO_OF(path));
 
     auto text = Util::readFile(path);
@@ -67,44 +109,41 @@ void SessionManager::restoreSession(const QString &path)
 
     app->setInitialized(false);
 
-    while (app->ui->tabWidget->count() > 0)
-    {
-        auto *tmp = app->windowAt(0);
-        app->ui->tabWidget->removeTab(0);
-        delete tmp;
-    }
-
     QJsonObject object = document.object();
+    const auto blobDirectory = blobDirectoryPath(path);
 
     const int currentIndex = object["currentIndex"].toInt();
     auto tabs = object["tabs"].toArray();
 
-    QProgressDialog progressDialog(app);
-    progressDialog.setWindowModality(Qt::WindowModal);
-    progressDialog.setWindowTitle(tr("Restoring Last Session"));
+    {
+        // Block the signals of the tab widget, otherwise AppWindow::onTabChanged() loads every tab that becomes the
+        // current tab while the tabs are removed and added.
+        const QSignalBlocker blocker(app->ui->tabWidget);
 
-    progressDialog.setMaximum(tabs.count());
-    progressDialog.setValue(0);
+        while (app->ui->tabWidget->count() > 0)
+        {
+            auto *tmp = app->ui->tabWidget->widget(0);
+            app->ui->tabWidget->removeTab(0);
+            delete tmp;
+        }
 
-    auto oldSize = app->size();
-    app->setUpdatesEnabled(false);
+        // Only placeholders are created here, a tab and its blobs are loaded when it's activated.
+        for (auto &&tab : tabs)
+        {
+            auto *placeholder = new Widgets::TabPlaceholder(tab.toObject().toVariantMap(), blobDirectory);
+            app->ui->tabWidget->addTab(placeholder, placeholder->getTabTitle(false, true));
+            app->updateTabIndex(placeholder);
+            trackTab(placeholder);
+        }
 
-    for (auto &&tab : tabs)
-    {
-        if (progressDialog.wasCanceled())
-            break;
-        auto status = MainWindow::EditorStatus(tab.toObject().toVariantMap());
-        app->openTab(status);
-        progressDialog.setLabelText(QString(tr("Restoring: [%1]")).arg(app->currentWindow()->getTabTitle(true, false)));
-        progressDialog.setValue(progressDialog.value() + 1);
+        if (currentIndex >= 0 && currentIndex < app->ui->tabWidget->count())
+            app->ui->tabWidget->setCurrentIndex(currentIndex);
     }
 
-    app->setUpdatesEnabled(true);
-    app->repaint();
-    app->resize(oldSize);
+    LOG_INFO("Restored " << tabs.count() << " tabs");
 
-    if (currentIndex >= 0 && currentIndex < app->ui->tabWidget->count())
-        app->ui->tabWidget->setCurrentIndex(currentIndex);
+    app->onTabChanged(app->ui->tabWidget->currentIndex()); // load the current tab
+    app->onEditorFileChanged();
 
     app->setInitialized();
 }
@@ -130,7 +169,15 @@ QString SessionManager::currentSessionText()
     QJsonArray arr;
     for (int t = 0; t < app->ui->tabWidget->count(); t++)
     {
-        arr.push_back(QJsonDocument::fromVariant(app->windowAt(t)->toStatus().toMap()).object());
+        auto *placeholder = app->placeholderAt(t);
+        QVariantMap status;
+        if (placeholder == nullptr)
+            status = app->windowAt(t)->toStatus().toMap();
+        else if (placeholder->hasSessionStatus()) // the exported session is self-contained
+            status = loadBlobs(placeholder->getSessionStatus(), placeholder->getBlobDirectory());
+        else
+            status = placeholder->getStatus().toMap();
+        arr.push_back(QJsonDocument::fromVariant(status).object());
     }
 
     json.insert("tabs", arr);
@@ -143,13 +190,228 @@ QString SessionManager::lastSessionPath()
     return Util::firstExistingConfigPath(sessionFileLocations);
 }
 
-void SessionManager::saveSession(const QString &sessionText)
+QVariantMap SessionManager::loadBlobs(QVariantMap status, const QString &directory)
 {
-    Util::saveFile(Util::configFilePath(sessionFileLocations[0]), sessionText, "Save Session", true, nullptr, true);
+    const QDir blobDirectory(directory);
+    for (auto const &key : blobTextKeys)
+    {
+        if (status.contains(key + blobKeySuffix))
+            status[key] = readBlob(blobDirectory, status.take(key + blobKeySuffix).toString());
+    }
+    for (auto const &key : blobListKeys)
+    {
+        if (status.contains(key + blobKeySuffix))
+        {
+            QStringList texts;
+            for (auto const &hash : status.take(key + blobKeySuffix).toStringList())
+                texts.push_back(readBlob(blobDirectory, hash));
+            status[key] = texts;
+        }
+    }
+    return status;
+}
+
+void SessionManager::trackTab(QWidget *tab)
+{
+    if (auto *window = qobject_cast<MainWindow *>(tab))
+        connect(window, &MainWindow::statusChanged, this,
+                [this](MainWindow *changed) { unchangedTabs.remove(changed); });
+    connect(tab, &QObject::destroyed, this,
+            [this](QObject *destroyed) { unchangedTabs.remove(static_cast<QWidget *>(destroyed)); });
+}
+
+void SessionManager::waitForSessionSaved()
+{
+    writerPool->waitForDone();
 }
 
 void SessionManager::updateSession()
 {
-    saveSession(currentSessionText());
+    QVector<QWidget *> tabs;
+    QVector<quintptr> tabIds;
+    QHash<quintptr, QVariantMap> changedTabs;
+    QHash<quintptr, QString> blobSources;
+
+    for (int t = 0; t < app->ui->tabWidget->count(); ++t)
+    {
+        auto *tab = app->ui->tabWidget->widget(t);
+        const auto id = reinterpret_cast<quintptr>(tab);
+        tabs.push_back(tab);
+        tabIds.push_back(id);
+        if (!unchangedTabs.contains(tab))
+        {
+            auto *placeholder = app->placeholderAt(t);
+            if (placeholder == nullptr)
+            {
+                changedTabs[id] = app->windowAt(t)->toStatus().toMap();
+            }
+            else if (placeholder->hasSessionStatus())
+            {
+                // keep the blob hashes, the blobs are not read before the tab is loaded
+                changedTabs[id] = placeholder->getSessionStatus();
+                blobSources[id] = placeholder->getBlobDirectory();
+            }
+            else
+            {
+                changedTabs[id] = placeholder->getStatus().toMap();
+            }
+            unchangedTabs.insert(tab);
+        }
+    }
+
+    const int currentIndex = app->ui->tabWidget->currentIndex();
+
+    if (changedTabs.isEmpty() && tabs == lastTabs && currentIndex == lastCurrentIndex)
+    {
+        LOG_INFO("The session is not changed");
+        return;
+    }
+
+    lastTabs = tabs;
+    lastCurrentIndex = currentIndex;
+
+    LOG_INFO(INFO_OF(tabs.count()) << INFO_OF(changedTabs.count()));
+
+    const auto path = Util::configFilePath(sessionFileLocations[0]);
+    writerPool->start(new Util::FunctionRunnable([this, path, currentIndex, tabIds, changedTabs, blobSources] {
+        writeSession(path, currentIndex, tabIds, changedTabs, blobSources);
+    }));
+}
+
+void SessionManager::onSessionWritten(const QString &path, bool success)
+{
+    if (success)
+    {
+        LOG_INFO("Successfully saved the session to [" << path << "]");
+    }
+    else
+    {
+        LOG_ERR("Failed to save the session to [" << path << "]");
+        // make sure that the session and the blobs will be written again in the next update
+        lastTabs.clear();
+        unchangedTabs.clear();
+    }
+}
+
+void SessionManager::writeSession(const QString &path, int currentIndex, const QVector<quintptr> &tabs,
+                                  const QHash<quintptr, QVariantMap> &changedTabs,
+                                  const QHash<quintptr, QString> &blobSources)
+{
+    // This runs on the worker thread, so it must not log or touch any widget.
+
+    const QDir blobDirectory(blobDirectoryPath(path));
+    if (!blobsOnDiskListed)
+    {
+        QDir().mkpath(blobDirectory.path());
+        for (auto const &name : blobDirectory.entryList(QDir::Files))
+            blobsOnDisk.insert(name);
+        blobsOnDiskListed = true;
+    }
+
+    bool success = true;
+
+    for (auto it = changedTabs.cbegin(); it != changedTabs.cend(); ++it)
+    {
+        auto status = it.value();
+        const QDir blobSource(blobSources.value(it.key()));
+        QStringList blobs;
+
+        auto writeBlob = [&](const QString &hash, const QByteArray &content) {
+            QSaveFile file(blobDirectory.filePath(hash));
+            if (file.open(QIODevice::WriteOnly) && file.write(content) == content.size() && file.commit())
+                blobsOnDisk.insert(hash);
+            else
+                success = false;
+        };
+
+        auto saveBlob = [&](const QString &text) {
+            if (text.isEmpty())
+                return QString();
+            const auto content = text.toUtf8();
+            const QString hash = QCryptographicHash::hash(content, QCryptographicHash::Sha1).toHex();
+            if (!blobsOnDisk.contains(hash))
+                writeBlob(hash, content);
+            blobs.push_back(hash);
+            return hash;
+        };
+
+        // the blob of a tab which is restored from another session and not loaded yet is copied from that session
+        auto keepBlob = [&](const QString &hash) {
+            if (hash.isEmpty())
+                return;
+            if (!blobsOnDisk.contains(hash))
+            {
+                QFile source(blobSource.filePath(hash));
+                if (source.open(QIODevice::ReadOnly))
+                    writeBlob(hash, source.readAll());
+            }
+            blobs.push_back(hash);
+        };
+
+        for (auto const &key : blobTextKeys)
+        {
+            if (status.contains(key + blobKeySuffix))
+                keepBlob(status.value(key + blobKeySuffix).toString());
+            else
+                status[key + blobKeySuffix] = saveBlob(status.take(key).toString());
+        }
+        for (auto const &key : blobListKeys)
+        {
+            if (status.contains(key + blobKeySuffix))
+            {
+                for (auto const &hash : status.value(key + blobKeySuffix).toStringList())
+                    keepBlob(hash);
+                continue;
+            }
+            QStringList hashes;
+            for (auto const &text : status.take(key).toStringList())
+                hashes.push_back(saveBlob(text));
+            status[key + blobKeySuffix] = hashes;
+        }
+
+        serializedTabs[it.key()] = QJsonDocument(QJsonObject::fromVariantMap(status)).toJson(QJsonDocument::Compact);
+        tabBlobs[it.key()] = blobs;
+    }
+
+    QHash<quintptr, QByteArray> openedTabs;
+    QHash<quintptr, QStringList> openedTabBlobs;
+    QByteArrayList tabTexts;
+    for (auto id : tabs)
+    {
+        openedTabs[id] = serializedTabs.value(id);
+        openedTabBlobs[id] = tabBlobs.value(id);
+        tabTexts.push_back(openedTabs[id]);
+    }
+    // forget the closed tabs
+    serializedTabs.swap(openedTabs);
+    tabBlobs.swap(openedTabBlobs);
+
+    if (success)
+    {
+        const QByteArray text = "{\"currentIndex\":" + QByteArray::number(currentIndex) + ",\"tabs\":[" +
+                                tabTexts.join(',') + "]}";
+
+        QSaveFile file(path);
+        success = file.open(QIODevice::WriteOnly) && file.write(text) == text.size() && file.commit();
+    }
+
+    if (success)
+    {
+        // the blobs that are not referenced by the new manifest are not needed any more
+        auto unusedBlobs = blobsOnDisk;
+        for (auto const &blobs : tabBlobs)
+        {
+            for (auto const &hash : blobs)
+                unusedBlobs.remove(hash);
+        }
+        for (auto const &hash : unusedBlobs)
+        {
+            if (QFile::remove(blobDirectory.filePath(hash)))
+                blobsOnDisk.remove(hash);
+        }
+    }
+
+    QMetaObject::invokeMethod(
+        this, [this, path, success] { onSessionWritten(path, success); }, Qt::QueuedConnection);
 }
 } // namespace Core
@@ -15,13 +15,35 @@
  *
  */
 
+/*
+ * The session is updated incrementally.
+ * A tab is marked as changed when anything in its status changes. When updating the session, only the statuses of
+ * the changed tabs are captured on the GUI thread. They are serialized and written to the session file on a worker
+ * thread, which keeps the serialized JSON of every tab and reuses it for the unchanged tabs.
+ * The session file is written with QSaveFile, so it's replaced atomically.
+ *
+ * The session file is a manifest which doesn't contain the texts of the tabs. The editor texts, the saved texts and
+ * the test cases are saved in blob files named by the SHA-1 of their contents, in a directory next to the manifest.
+ * A blob is written only if it doesn't exist yet, so identical texts are saved once, and unchanged texts are never
+ * written again. Blobs that are not referenced by the manifest are removed after the manifest is written.
+ * When restoring the session, the blobs of a tab are only read when the tab is loaded. Until then, the tab is saved
+ * with the hashes of its blobs, which are copied by the worker thread if the session is restored from somewhere else.
+ * The exported session is still self-contained, and sessions with inline texts can still be restored.
+ */
+
 #ifndef SESSION_MANAGER_HPP
 #define SESSION_MANAGER_HPP
 
+#include <QHash>
 #include <QObject>
+#include <QSet>
+#include <QVariantMap>
+#include <QVector>
 
 class AppWindow;
+class QThreadPool;
 class QTimer;
+class QWidget;
 
 namespace Core
 {
@@ -32,6 +54,8 @@ class SessionManager : public QObject
   public:
     explicit SessionManager(AppWindow *appwindow);
 
+    ~SessionManager() override;
+
     void restoreSession(const QString &path);
 
     void setAutoUpdateSession(bool shouldAutoUpdate);
@@ -42,14 +66,45 @@ class SessionManager : public QObject
 
     static QString lastSessionPath();
 
-    static void saveSession(const QString &sessionText);
+    /**
+     * @brief replace the blob hashes in the status of a tab by the texts in the blobs
+     * @note This reads the blobs, so it should only be called when the texts are needed, e.g. the tab is loaded.
+     */
+    static QVariantMap loadBlobs(QVariantMap status, const QString &blobDirectory);
+
+    /**
+     * @brief track the status changes of a tab, which is either a MainWindow or a Widgets::TabPlaceholder
+     * @note every tab should be tracked, otherwise it will only be saved when it's saved for the first time
+     */
+    void trackTab(QWidget *tab);
+
+    /**
+     * @brief block until all the requested session updates are written to the disk
+     */
+    void waitForSessionSaved();
 
   public slots:
     void updateSession();
 
+  private slots:
+    void onSessionWritten(const QString &path, bool success);
+
   private:
+    void writeSession(const QString &path, int currentIndex, const QVector<quintptr> &tabs,
+                      const QHash<quintptr, QVariantMap> &changedTabs, const QHash<quintptr, QString> &blobSources);
+
     QTimer *timer = nullptr;
     AppWindow *app = nullptr;
+
+    QSet<QWidget *> unchangedTabs; // tabs whose latest statuses have been sent to the writer
+    QVector<QWidget *> lastTabs;   // the tabs in the last requested session update
+    int lastCurrentIndex = -1;     // the current index in the last requested session update
+
+    QThreadPool *writerPool = nullptr;          // runs at most one writeSession() at a time
+    QHash<quintptr, QByteArray> serializedTabs; // only accessed in writeSession()
+    QHash<quintptr, QStringList> tabBlobs;      // the blobs referenced by each tab, only accessed in writeSession()
+    QSet<QString> blobsOnDisk;                  // only accessed in writeSession()
+    bool blobsOnDiskListed = false;             // whether blobsOnDisk is initialized, only accessed in writeSession()
 };
 } // namespace Core
 
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/StartupTracer.hpp"
+#include "Core/EventLogger.hpp"
+#include "Util/FileUtil.hpp"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+#include <atomic>
+
+namespace Core
+{
+
+struct TraceEvent
+{
+    const char *name;
+    QString detail;
+    qint64 begin; // nanoseconds since StartupTracer::start()
+    qint64 end;   // -1 for an instant event
+    Qt::HANDLE thread;
+};
+
+static QElapsedTimer traceClock;
+static std::atomic_bool recording{false};
+static QMutex traceMutex; // guards traceEvents, the events may be recorded in other threads
+static QVector<TraceEvent> traceEvents;
+static Qt::HANDLE mainThread = nullptr;
+static QString outputPath;
+
+static void addEvent(const char *name, const QString &detail, qint64 begin, qint64 end)
+{
+    QMutexLocker locker(&traceMutex);
+    traceEvents.push_back({name, detail, begin, end, QThread::currentThreadId()});
+}
+
+/**
+ * @brief calls StartupTracer::finish() after the first paint event of the watched widget
+ */
+class FirstPaintFilter : public QObject
+{
+  public:
+    using QObject::QObject;
+
+  protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint)
+        {
+            StartupTracer::mark("First Paint");
+            watched->removeEventFilter(this);
+            deleteLater();
+            // finish after the paint event is handled, so that the whole first frame is included
+            QTimer::singleShot(0, &StartupTracer::finish);
+        }
+        return false;
+    }
+};
+
+StartupTracer::Scope::Scope(const char *name, const QString &detail) : name(name)
+{
+    if (isRecording())
+    {
+        this->detail = detail;
+        begin = traceClock.nsecsElapsed();
+    }
+}
+
+StartupTracer::Scope::~Scope()
+{
+    end();
+}
+
+void StartupTracer::Scope::end()
+{
+    if (begin == -1 || !isRecording())
+        return;
+    addEvent(name, detail, begin, traceClock.nsecsElapsed());
+    begin = -1;
+}
+
+void StartupTracer::start()
+{
+    traceClock.start();
+    mainThread = QThread::currentThreadId();
+    recording = true;
+}
+
+void StartupTracer::setOutputPath(const QString &path)
+{
+    outputPath = path;
+}
+
+void StartupTracer::mark(const char *name)
+{
+    if (isRecording())
+        addEvent(name, QString(), traceClock.nsecsElapsed(), -1);
+}
+
+void StartupTracer::finishOnFirstPaint(QWidget *widget)
+{
+    if (isRecording())
+        widget->installEventFilter(new FirstPaintFilter(widget));
+}
+
+void StartupTracer::finish()
+{
+    if (!recording.exchange(false))
+        return;
+
+    const qint64 total = traceClock.nsecsElapsed();
+    LOG_INFO("Startup finished in " << total / 1000000 << "ms");
+
+    QVector<TraceEvent> events;
+    {
+        QMutexLocker locker(&traceMutex);
+        events.swap(traceEvents);
+    }
+
+    if (outputPath.isEmpty())
+        return;
+
+    events.push_front({"Startup", QString(), 0, total, mainThread});
+
+    const auto pid = QCoreApplication::applicationPid();
+    QHash<Qt::HANDLE, int> threadIds{{mainThread, 1}};
+    QJsonArray traceArray;
+
+    QJsonObject mainThreadName;
+    mainThreadName["name"] = "thread_name";
+    mainThreadName["ph"] = "M";
+    mainThreadName["pid"] = pid;
+    mainThreadName["tid"] = 1;
+    mainThreadName["args"] = QJsonObject{{"name", "Main Thread"}};
+    traceArray.push_back(mainThreadName);
+
+    for (const auto &event : events)
+    {
+        if (!threadIds.contains(event.thread))
+        {
+            const int id = threadIds.size() + 1;
+            threadIds[event.thread] = id;
+        }
+
+        QJsonObject object;
+        object["name"] = event.name;
+        object["cat"] = "startup";
+        object["pid"] = pid;
+        object["tid"] = threadIds[event.thread];
+        object["ts"] = event.begin / 1000.0; // the timestamps are in microseconds
+        if (event.end == -1)
+        {
+            object["ph"] = "i";
+            object["s"] = "p";
+        }
+        else
+        {
+            object["ph"] = "X";
+            object["dur"] = (event.end - event.begin) / 1000.0;
+        }
+        if (!event.detail.isEmpty())
+            object["args"] = QJsonObject{{"detail", event.detail}};
+        traceArray.push_back(object);
+    }
+
+    QJsonObject json;
+    json["traceEvents"] = traceArray;
+    json["displayTimeUnit"] = "ms";
+
+    if (Util::saveFile(outputPath, QJsonDocument(json).toJson(QJsonDocument::Compact), "Startup Trace", true,
+                       nullptr, true))
+        LOG_INFO("Startup trace is written to " << outputPath);
+}
+
+bool StartupTracer::isRecording()
+{
+    return recording;
+}
+
+} // namespace Core
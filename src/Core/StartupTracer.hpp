@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+/*
+ * The startup tracer records how long each step of the startup takes, from main() to the first paint of the main
+ * window. The timings are written into a Chrome trace-event JSON file, which can be opened in chrome://tracing or
+ * https://ui.perfetto.dev, if a path is given by the --trace-startup command line option.
+ */
+
+#ifndef STARTUPTRACER_HPP
+#define STARTUPTRACER_HPP
+
+#include <QString>
+
+class QWidget;
+
+#define TRACE_STARTUP_CONCAT_IMPL(a, b) a##b
+#define TRACE_STARTUP_CONCAT(a, b) TRACE_STARTUP_CONCAT_IMPL(a, b)
+
+/**
+ * @brief trace the rest of the current scope
+ * @note The arguments are the same as the constructor of Core::StartupTracer::Scope.
+ */
+#define TRACE_STARTUP(...)                                                                                             \
+    const Core::StartupTracer::Scope TRACE_STARTUP_CONCAT(startupTracerScope, __LINE__)(__VA_ARGS__)
+
+namespace Core
+{
+class StartupTracer
+{
+  public:
+    /**
+     * @brief records the time between its construction and destruction (or end()) as a trace event
+     */
+    class Scope
+    {
+      public:
+        /**
+         * @param name the name of the event, it must be a string literal
+         * @param detail shown in the arguments of the event, e.g. the language of a language server
+         */
+        explicit Scope(const char *name, const QString &detail = QString());
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        /**
+         * @brief end the event before the end of the scope
+         */
+        void end();
+
+      private:
+        const char *name;
+        QString detail;
+        qint64 begin = -1; // -1 if the tracer is not recording or the event is ended
+    };
+
+    /**
+     * @brief start the clock of the tracer
+     * @note This should be called at the very beginning of main(). The events are recorded in memory until finish().
+     */
+    static void start();
+
+    /**
+     * @brief set the path of the trace file
+     * @param path the path of the trace file, the events are discarded in finish() if it's empty
+     */
+    static void setOutputPath(const QString &path);
+
+    /**
+     * @brief record an instant event
+     * @param name the name of the event, it must be a string literal
+     */
+    static void mark(const char *name);
+
+    /**
+     * @brief record the first paint of the widget, and call finish() after it
+     */
+    static void finishOnFirstPaint(QWidget *widget);
+
+    /**
+     * @brief stop recording, and write the trace file if the output path is set
+     */
+    static void finish();
+
+    /**
+     * @brief whether the events are being recorded
+     */
+    static bool isRecording();
+};
+} // namespace Core
+
+#endif // STARTUPTRACER_HPP
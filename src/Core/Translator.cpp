@@ -17,6 +17,7 @@
 
 #include "Core/Translator.hpp"
 #include "Core/EventLogger.hpp"
+#include "Core/StartupTracer.hpp"
 #include "generated/SettingsHelper.hpp"
 #include <QMap>
 #include <QTranslator>
@@ -37,6 +38,7 @@ QTranslator *Translator::translator = nullptr;
 
 void Translator::setLocale()
 {
+    TRACE_STARTUP("Core::Translator::setLocale");
     const auto language = SettingsHelper::getLocale();
     LOG_INFO(INFO_OF(language));
     if (translator)
@@ -66,7 +66,6 @@ CodeEditor::CodeEditor(QWidget *widget) : QPlainTextEdit(widget)
 {
     highlighter = new Highlighter(document());
     sideBar = new CodeEditorSidebar(this);
-    languageRepo = new LanguageRepository(SettingsHelper::getDefaultLanguage(), this);
 
     connect(document(), &QTextDocument::blockCountChanged, this, &CodeEditor::updateSidebarGeometry);
     connect(this, &QPlainTextEdit::updateRequest, this, &CodeEditor::updateSidebarArea);
@@ -76,6 +75,14 @@ CodeEditor::CodeEditor(QWidget *widget) : QPlainTextEdit(widget)
 
     setCenterOnScroll(true);
     setMouseTracking(true);
+
+    using SettingsHelper::Key;
+    SettingsManager::subscribe(this,
+                               {Key::TabWidth, Key::CursorWidth, Key::EditorFont, Key::WrapText,
+                                Key::HighlightErrorLine, Key::ExtraBottomMargin, Key::EditorTheme, Key::UIStyle,
+                                Key::CppParentheses, Key::JavaParentheses, Key::PythonParentheses,
+                                Key::AutoCompleteParentheses, Key::AutoRemoveParentheses, Key::TabJumpOutParentheses},
+                               [this] { applySettings(language); });
 }
 
 void CodeEditor::applySettings(const QString &lang)
@@ -83,7 +90,6 @@ void CodeEditor::applySettings(const QString &lang)
     LOG_INFO("Applying settings to a CodeEditor");
 
     language = lang;
-    languageRepo->changeLanguage(lang);
 
     m_tabReplace = QString(SettingsHelper::getTabWidth(), ' ');
     setTabStopDistance(fontMetrics().horizontalAdvance(QString(SettingsHelper::getTabWidth() * 200, ' ')) / 200.0);
@@ -621,18 +627,20 @@ void CodeEditor::duplicate()
 
 void CodeEditor::toggleComment()
 {
-    const QString comment = languageRepo->singleLineCommentToken();
+    static const QRegularExpression contentStart("\\S|^\\s*$");
+    const auto &config = LanguageRepository::language(language);
 
-    if (!removeInEachLineOfSelection(QRegularExpression("^\\s*(" + comment + " ?)"), false))
+    if (!removeInEachLineOfSelection(config.singleLineCommentRegEx, false))
     {
-        addInEachLineOfSelection(QRegularExpression("\\S|^\\s*$"), comment + " ");
+        addInEachLineOfSelection(contentStart, config.singleLineCommentToken + " ");
     }
 }
 
 void CodeEditor::toggleBlockComment()
 {
-    const QString commentStart = languageRepo->blockCommentTokens().first;
-    const QString commentEnd = languageRepo->blockCommentTokens().second;
+    const auto &tokens = LanguageRepository::language(language).blockCommentTokens;
+    const QString commentStart = tokens.first;
+    const QString commentEnd = tokens.second;
 
     if (commentStart.isEmpty() || commentEnd.isEmpty())
         return;
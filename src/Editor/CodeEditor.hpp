@@ -55,7 +55,6 @@ class SyntaxHighlighter;
 namespace Editor
 {
 class CodeEditorSidebar;
-class LanguageRepository;
 
 class CodeEditor : public QPlainTextEdit
 {
@@ -329,8 +328,6 @@ class CodeEditor : public QPlainTextEdit
 
     QString language;
 
-    LanguageRepository *languageRepo;
-
     friend class CodeEditorSidebar;
 };
 } // namespace Editor
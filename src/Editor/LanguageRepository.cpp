@@ -17,62 +17,63 @@
 
 #include "Editor/LanguageRepository.hpp"
 #include "Util/FileUtil.hpp"
-#include <QDebug>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QString>
 
 namespace Editor
 {
-LanguageRepository::LanguageRepository(const QString &language, QObject *parent) : QObject(parent)
-{
-    QString jsonDoc = Util::readFile(":/language_config.json");
-    doc = QJsonDocument::fromJson(jsonDoc.toLocal8Bit());
-    QJsonObject jsonObject = doc[language].toObject();
-}
-
-void LanguageRepository::changeLanguage(const QString &newLang)
-{
-    obj = doc[newLang].toObject();
-}
-
-QString LanguageRepository::singleLineCommentToken() const
-{
-    return obj["singleLineCommentToken"].toString();
-}
+// a regular expression that never matches, used when a language doesn't have the tokens
+static const char *const NEVER_MATCH = "(?!)";
 
-QPair<QString, QString> LanguageRepository::blockCommentTokens() const
+const LanguageRepository::Language &LanguageRepository::language(const QString &name)
 {
-    QPair<QString, QString> res;
-    res.first = obj["blockCommentTokens"].toArray()[0].toString();
-    res.second = obj["blockCommentTokens"].toArray()[1].toString();
-    return res;
-}
+    // initialized once in a thread-safe way, and read-only after that
+    static const QHash<QString, Language> languages = parseLanguages();
+    static const Language unknown{{}, {}, {}, QRegularExpression(NEVER_MATCH), QRegularExpression(NEVER_MATCH),
+                                  QRegularExpression(NEVER_MATCH)};
 
-QPair<QString, QString> LanguageRepository::rawStringTokens() const
-{
-    QPair<QString, QString> res;
-    res.first = obj["rawStringTokens"].toArray()[0].toString();
-    res.second = obj["rawStringTokens"].toArray()[1].toString();
-    return res;
+    auto it = languages.constFind(name);
+    return it == languages.constEnd() ? unknown : *it;
 }
 
-QRegExp LanguageRepository::singleLineCommentRegEx() const
+QHash<QString, LanguageRepository::Language> LanguageRepository::parseLanguages()
 {
-    auto token = singleLineCommentToken();
-    return QRegExp(token + ".*");
-}
+    auto tokenPair = [](const QJsonValue &value) {
+        const auto array = value.toArray();
+        return qMakePair(array[0].toString(), array[1].toString());
+    };
 
-QRegExp LanguageRepository::blockCommentRegEx() const
-{
-    auto tokens = blockCommentTokens();
-    return QRegExp(tokens.first + R"((\n|.)*?)" + tokens.second);
-}
+    auto enclosedRegEx = [](const QPair<QString, QString> &tokens) {
+        if (tokens.first.isEmpty() || tokens.second.isEmpty())
+            return QRegularExpression(NEVER_MATCH);
+        return QRegularExpression(QRegularExpression::escape(tokens.first) + R"([\s\S]*?)" +
+                                  QRegularExpression::escape(tokens.second));
+    };
 
-QRegExp LanguageRepository::rawStringRegEx() const
-{
-    auto tokens = rawStringTokens();
-    return QRegExp(tokens.first + R"((\n|.)*?)" + tokens.second);
+    QHash<QString, Language> languages;
+    const auto doc = QJsonDocument::fromJson(Util::readFile(":/language_config.json").toUtf8());
+    const auto root = doc.object();
+    for (auto it = root.constBegin(); it != root.constEnd(); ++it)
+    {
+        const auto object = it.value().toObject();
+        Language config;
+        config.singleLineCommentToken = object["singleLineCommentToken"].toString();
+        config.blockCommentTokens = tokenPair(object["blockCommentTokens"]);
+        config.rawStringTokens = tokenPair(object["rawStringTokens"]);
+        config.singleLineCommentRegEx =
+            config.singleLineCommentToken.isEmpty()
+                ? QRegularExpression(NEVER_MATCH)
+                : QRegularExpression(R"(^\s*()" + QRegularExpression::escape(config.singleLineCommentToken) + " ?)");
+        config.blockCommentRegEx = enclosedRegEx(config.blockCommentTokens);
+        config.rawStringRegEx = enclosedRegEx(config.rawStringTokens);
+        // compile them now, instead of when they are used for the first time
+        config.singleLineCommentRegEx.optimize();
+        config.blockCommentRegEx.optimize();
+        config.rawStringRegEx.optimize();
+        languages.insert(it.key(), config);
+    }
+    return languages;
 }
 } // namespace Editor
@@ -15,35 +15,50 @@
  *
  */
 
+/*
+ * The LanguageRepository provides the comment and raw string tokens of the languages.
+ * The configurations are parsed from :/language_config.json once in the process, with the regular expressions
+ * compiled, and they are shared by all the editors. They are never changed after that, so they are thread-safe.
+ */
+
 #ifndef LANGUAGEREPOSITORY_HPP
 #define LANGUAGEREPOSITORY_HPP
 
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QObject>
-
-class QRegExp;
+#include <QHash>
+#include <QPair>
+#include <QRegularExpression>
+#include <QString>
 
 namespace Editor
 {
-class LanguageRepository : public QObject
+class LanguageRepository
 {
   public:
-    LanguageRepository(const QString &language, QObject *parent = nullptr);
-    void changeLanguage(const QString &newLang);
-
-    QString singleLineCommentToken() const;
-    QPair<QString, QString> blockCommentTokens() const;
-    QPair<QString, QString> rawStringTokens() const;
+    // The configuration of a language
+    struct Language
+    {
+        QString singleLineCommentToken;             // e.g. "//", empty if there's no single line comment
+        QPair<QString, QString> blockCommentTokens; // e.g. {"/*", "*/"}, empty if there's no block comment
+        QPair<QString, QString> rawStringTokens;    // e.g. {"R\"(", ")\""}, empty if there's no raw string
+        QRegularExpression singleLineCommentRegEx;  // captures "// " and the indentation before it in a line
+        QRegularExpression blockCommentRegEx;       // matches a block comment
+        QRegularExpression rawStringRegEx;          // matches a raw string
+    };
 
-    QRegExp singleLineCommentRegEx() const;
-    QRegExp blockCommentRegEx() const;
-    QRegExp rawStringRegEx() const;
+    /**
+     * @brief get the configuration of a language
+     * @param name the name of the language, one of "C++", "Java" and "Python"
+     * @returns the shared configuration, or an empty configuration whose regular expressions never match if the
+     *          language is unknown
+     * @note The configurations are parsed on the first call.
+     */
+    static const Language &language(const QString &name);
 
   private:
-    QString language;
-    QJsonDocument doc;
-    QJsonObject obj;
+    /**
+     * @brief parse :/language_config.json
+     */
+    static QHash<QString, Language> parseLanguages();
 };
 
 } // namespace Editor
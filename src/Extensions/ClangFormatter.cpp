@@ -16,9 +16,6 @@
  */
 
 #include "Extensions/ClangFormatter.hpp"
-#include "Editor/CodeEditor.hpp"
-#include <QJsonDocument>
-#include <QTextCursor>
 
 namespace Extensions
 {
@@ -36,7 +33,7 @@ QString ClangFormatter::settingKey() const
 
 QStringList ClangFormatter::arguments() const
 {
-    return {"--style=file", QString("--cursor=%1").arg(anchorPos())};
+    return {"--style=file"};
 }
 
 QStringList ClangFormatter::rangeArgs() const
@@ -52,36 +49,7 @@ QString ClangFormatter::styleFileName() const
 
 QString ClangFormatter::newSource(const QString &out) const
 {
-    return out.mid(out.indexOf('\n') + 1);
-}
-
-QTextCursor ClangFormatter::newCursor(const QString &out, const QStringList &args) const
-{
-    auto cursor = editor()->textCursor();
-    cursor.setPosition(newCursorPos(out));
-
-    if (cursorPos() != anchorPos())
-    {
-        // change the `--cursor` argument and format again to get the position of the other end of the selection
-
-        QStringList newArgs;
-
-        for (const auto &arg : qAsConst(args))
-            if (!arg.startsWith("--cursor"))
-                newArgs.append(arg);
-        newArgs.append(QString("--cursor=%1").arg(cursorPos()));
-
-        auto res = runProcess(newArgs);
-        cursor.setPosition(newCursorPos(res), QTextCursor::KeepAnchor);
-    }
-
-    return cursor;
-}
-
-int ClangFormatter::newCursorPos(const QString &out) const // NOLINT: method 'newCursorPos' can be made static
-{
-    auto json = QJsonDocument::fromJson(out.left(out.indexOf('\n')).toUtf8());
-    return json["Cursor"].toInt();
+    return out;
 }
 
 } // namespace Extensions
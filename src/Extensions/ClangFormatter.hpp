@@ -17,7 +17,7 @@
 
 /*
  * The Formatter is used to format codes.
- * It runs synchronously, so the event loop is blocked while formatting.
+ * It runs asynchronously unless it's asked to wait, see CodeFormatter.
  * The time limit for formatting is 2 seconds.
  */
 
@@ -46,11 +46,6 @@ class ClangFormatter : public CodeFormatter
     QString styleFileName() const override;
 
     QString newSource(const QString &out) const override;
-
-    QTextCursor newCursor(const QString &out, const QStringList &args) const override;
-
-  private:
-    int newCursorPos(const QString &out) const;
 };
 
 } // namespace Extensions
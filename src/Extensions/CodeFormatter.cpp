@@ -19,14 +19,30 @@
 #include "Core/EventLogger.hpp"
 #include "Core/MessageLogger.hpp"
 #include "Editor/CodeEditor.hpp"
+#include "Extensions/FormatterWorker.hpp"
 #include "Settings/SettingsManager.hpp"
+#include "Util/DiffUtil.hpp"
 #include "Util/FileUtil.hpp"
+#include <QDeadlineTimer>
 #include <QProcess>
+#include <QScrollBar>
 #include <QTemporaryDir>
+#include <QTextBlock>
+#include <QTimer>
 
 namespace Extensions
 {
 
+/**
+ * @brief the temporary directory where the formatters write the source files and the style files
+ * @note It's created when it's used for the first time, and removed when the application exits.
+ */
+static QTemporaryDir *workspace()
+{
+    static QTemporaryDir dir;
+    return dir.isValid() ? &dir : nullptr;
+}
+
 CodeFormatter::CodeFormatter(Editor::CodeEditor *editor, const QString &lang, bool selectionOnly, bool logOnNoChange,
                              MessageLogger *log, QObject *parent)
     : QObject(parent), m_editor(editor), m_lang(lang), m_selectionOnly(selectionOnly), m_logOnNoChange(logOnNoChange),
@@ -43,102 +59,333 @@ CodeFormatter::CodeFormatter(Editor::CodeEditor *editor, const QString &lang, bo
     m_anchorLine = cursor.blockNumber();
     m_anchorCol = cursor.columnNumber();
 
+    m_revision = editor->document()->revision();
+    m_text = editor->toPlainText();
+
     LOG_INFO(INFO_OF(m_cursorPos) << INFO_OF(m_cursorLine) << INFO_OF(m_anchorPos) << INFO_OF(m_anchorLine));
 }
 
-void CodeFormatter::format() const
+CodeFormatter::~CodeFormatter()
 {
-    QStringList args = arguments() << QProcess::splitCommand(getSetting("Arguments").toString());
-
-    if (formatSelectionOnly())
-        args.append(rangeArgs());
+    if (m_process != nullptr && m_process->state() != QProcess::NotRunning)
+        m_process->kill();
+}
 
-    QTemporaryDir tmpDir;
-    if (!tmpDir.isValid())
+void CodeFormatter::format(bool wait)
+{
+    auto *dir = workspace();
+    if (dir == nullptr)
     {
         log->error(tr("Formatter"), tr("Failed to create temporary directory"));
+        finish();
         return;
     }
 
-    auto tmpPath = tmpDir.filePath(Util::fileNameWithSuffix("tmp", m_lang));
-    args.append(tmpPath);
-
-    if (!Util::saveFile(tmpPath, m_editor->toPlainText(), tr("Formatter"), true, log))
-        return;
-
-    if (!Util::saveFile(tmpDir.filePath(styleFileName()), getSetting("Style").toString(), tr("Formatter"), true, log))
+    const auto style = getSetting("Style").toString();
+    const auto stylePath = dir->filePath(styleFileName());
+    if (!Util::saveFile(stylePath, style, tr("Formatter"), false, log, false, Util::FileKind::Temp))
+    {
+        finish();
         return;
+    }
 
-    auto res = runProcess(args);
-    if (res.isEmpty())
+    if (auto *worker = this->worker())
+    {
+        formatWithWorker(worker, style.isEmpty() ? QString() : stylePath, wait);
         return;
+    }
 
-    auto source = newSource(res);
+    // each editor has its own source file, so that formatters in different tabs don't conflict
+    m_sourcePath = dir->filePath(
+        Util::fileNameWithSuffix(QString("source-%1").arg(reinterpret_cast<quintptr>(m_editor.data())), m_lang));
 
-    if (source == m_editor->toPlainText())
+    if (!Util::saveFile(m_sourcePath, m_text, tr("Formatter"), false, log, false, Util::FileKind::Temp))
     {
-        if (m_logOnNoChange)
-            log->info(tr("Formatter"), tr("Formatting completed"));
+        finish();
         return;
     }
 
-    auto cursor = m_editor->textCursor();
-    cursor.select(QTextCursor::Document);
-    cursor.insertText(source);
+    QStringList args = arguments() << QProcess::splitCommand(getSetting("Arguments").toString());
+    if (formatSelectionOnly())
+        args.append(rangeArgs());
+    args.append(m_sourcePath);
 
-    m_editor->setTextCursor(newCursor(res, args));
+    m_process = new QProcess(this);
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            &CodeFormatter::onProcessFinished);
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart)
+            onProcessFailedToStart();
+    });
+    connect(m_timer, &QTimer::timeout, this, &CodeFormatter::onTimeout);
 
-    log->info(tr("Formatter"), tr("Formatting completed"));
-}
+    m_process->start(getSetting("Program").toString(), args);
+    m_timer->start(FORMAT_TIMEOUT);
+    LOG_INFO(INFO_OF(m_process->program()) << INFO_OF(m_process->arguments().join(' ')));
 
-QString CodeFormatter::runProcess(const QStringList &args) const
-{
-    QProcess formatProcess;
-    formatProcess.start(getSetting("Program").toString(), args);
-    LOG_INFO(INFO_OF(formatProcess.program()) << INFO_OF(formatProcess.arguments().join(' ')));
-
-    bool finished = formatProcess.waitForFinished(2000); // blocks main Thread
-    if (!finished)
+    if (wait && !m_finished)
     {
-        formatProcess.kill();
-        log->error(tr("Formatter"),
-                   tr("The format process didn't finish in 2 seconds. This is probably because the %1 program is not "
-                      "found by CP Editor. You can set the path to the program at %2.")
-                       .arg(settingKey())
-                       .arg(SettingsManager::getPathText(settingKey() + "/Program")),
-                   false);
-        return QString();
+        // the slots are usually called by the signals in waitForFinished(), and calling them again does nothing
+        if (m_process->waitForFinished(FORMAT_TIMEOUT))
+            onProcessFinished();
+        else if (m_process->error() == QProcess::FailedToStart)
+            onProcessFailedToStart();
+        else
+            onTimeout();
     }
+}
 
-    auto exitCode = formatProcess.exitCode();
+void CodeFormatter::onProcessFinished()
+{
+    if (m_finished)
+        return;
 
-    if (exitCode != 0)
+    auto exitCode = m_process->exitCode();
+
+    if (m_process->exitStatus() != QProcess::NormalExit || exitCode != 0)
     {
         LOG_WARN(INFO_OF(exitCode));
 
         log->warn(tr("Formatter"), tr("The format command [%1 %2] finished with exit code %3.")
-                                       .arg(formatProcess.program())
-                                       .arg(formatProcess.arguments().join(' '))
+                                       .arg(m_process->program())
+                                       .arg(m_process->arguments().join(' '))
                                        .arg(exitCode));
-        auto stdOut = formatProcess.readAllStandardOutput();
+        auto stdOut = m_process->readAllStandardOutput();
         if (!stdOut.isEmpty())
             log->warn(tr("Formatter[stdout]"), stdOut);
-        auto stdError = formatProcess.readAllStandardError();
+        auto stdError = m_process->readAllStandardError();
         if (!stdError.isEmpty())
             log->error(tr("Formatter[stderr]"), stdError);
-        return QString();
+        finish();
+        return;
+    }
+
+    onFormatted(m_process->readAllStandardOutput());
+}
+
+void CodeFormatter::formatWithWorker(FormatterWorker *worker, const QString &stylePath, bool wait)
+{
+    m_worker = worker;
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(worker, &FormatterWorker::responded, this, &CodeFormatter::onWorkerResponded);
+    connect(m_timer, &QTimer::timeout, this, &CodeFormatter::onTimeout);
+
+    m_requestId = worker->request(workerRequest(m_text, stylePath));
+    m_timer->start(FORMAT_TIMEOUT);
+    LOG_INFO(INFO_OF(m_requestId));
+
+    if (wait)
+    {
+        // the response is emitted in waitForReadyRead() if it's ready
+        QDeadlineTimer deadline(FORMAT_TIMEOUT);
+        while (!m_finished && !m_worker.isNull() && !deadline.hasExpired())
+        {
+            if (!m_worker->waitForReadyRead(int(deadline.remainingTime())))
+                break;
+        }
+        if (!m_finished)
+            onTimeout();
+    }
+}
+
+void CodeFormatter::onWorkerResponded(int id, const QJsonObject &response)
+{
+    if (m_finished || id != m_requestId)
+        return;
+
+    if (response["failedToStart"].toBool())
+    {
+        onProcessFailedToStart();
+        return;
+    }
+
+    if (response.contains("error"))
+    {
+        LOG_WARN(INFO_OF(response["error"].toString()));
+        log->error(tr("Formatter"), tr("Failed to format the code: %1").arg(response["error"].toString()));
+        finish();
+        return;
     }
 
-    auto out = formatProcess.readAllStandardOutput();
+    onFormatted(response["source"].toString());
+}
 
+void CodeFormatter::onFormatted(const QString &out)
+{
     if (out.isEmpty())
     {
         LOG_WARN("Output is empty");
         log->warn(tr("Formatter"), tr("The output of the format process is empty. Please ensure there is no in-place "
                                       "modification option in the formatting arguments."));
+        finish();
+        return;
+    }
+
+    if (m_editor.isNull())
+    {
+        finish();
+        return;
+    }
+
+    if (m_editor->document()->revision() != m_revision)
+    {
+        LOG_INFO("The code is changed while formatting");
+        log->warn(tr("Formatter"), tr("The code is changed while formatting, so the result is discarded."));
+        finish();
+        return;
+    }
+
+    auto source = newSource(out);
+
+    if (source == m_text)
+    {
+        if (m_logOnNoChange)
+            log->info(tr("Formatter"), tr("Formatting completed"));
+        finish();
+        return;
     }
 
-    return out;
+    applySource(source);
+
+    log->info(tr("Formatter"), tr("Formatting completed"));
+    finish();
+}
+
+void CodeFormatter::onProcessFailedToStart()
+{
+    if (m_finished)
+        return;
+    log->error(tr("Formatter"),
+               tr("Failed to start the format process. This is probably because the %1 program is not found by CP "
+                  "Editor. You can set the path to the program at %2.")
+                   .arg(settingKey())
+                   .arg(SettingsManager::getPathText(settingKey() + "/Program")),
+               false);
+    finish();
+}
+
+void CodeFormatter::onTimeout()
+{
+    if (m_finished)
+        return;
+    if (m_process != nullptr)
+        m_process->kill();
+    else if (!m_worker.isNull())
+    {
+        // the worker may be stuck, it's restarted on the next request
+        m_worker->disconnect(this);
+        m_worker->kill();
+    }
+    log->error(tr("Formatter"),
+               tr("The format process didn't finish in 2 seconds. This is probably because the %1 program is not "
+                  "found by CP Editor. You can set the path to the program at %2.")
+                   .arg(settingKey())
+                   .arg(SettingsManager::getPathText(settingKey() + "/Program")),
+               false);
+    finish();
+}
+
+void CodeFormatter::applySource(const QString &source)
+{
+    auto *document = m_editor->document();
+    const auto oldLines = m_text.split('\n');
+    const auto newLines = source.split('\n');
+    const auto hunks = Util::lineDiff(oldLines, newLines);
+
+    // map a position in the old code to the same column of the corresponding line in the new code
+    const auto mapPosition = [&](int line, int col) {
+        int newLine = line;
+        for (const auto &hunk : hunks)
+        {
+            if (line < hunk.oldStart)
+                break;
+            if (line < hunk.oldStart + hunk.oldCount)
+            {
+                newLine = hunk.newStart + qMin(line - hunk.oldStart, qMax(hunk.newCount - 1, 0));
+                if (hunk.newCount == 0)
+                    col = 0;
+                break;
+            }
+            newLine += hunk.newCount - hunk.oldCount;
+        }
+        newLine = qBound(0, newLine, newLines.size() - 1);
+        return qMakePair(newLine, qMin(col, newLines[newLine].length()));
+    };
+    const auto newAnchor = mapPosition(m_anchorLine, m_anchorCol);
+    const auto newCursor = mapPosition(m_cursorLine, m_cursorCol);
+
+    const int horizontalScroll = m_editor->horizontalScrollBar()->value();
+    const int verticalScroll = m_editor->verticalScrollBar()->value();
+
+    QTextCursor cursor(document);
+    cursor.beginEditBlock();
+    // apply the hunks from the end, so that the positions of the lines before them are not changed
+    for (int i = hunks.size() - 1; i >= 0; --i)
+    {
+        const auto &hunk = hunks[i];
+        const auto lines = newLines.mid(hunk.newStart, hunk.newCount);
+        int start = 0;
+        int end = 0;
+        QString text;
+        if (hunk.oldStart + hunk.oldCount < oldLines.size())
+        {
+            start = document->findBlockByNumber(hunk.oldStart).position();
+            end = document->findBlockByNumber(hunk.oldStart + hunk.oldCount).position();
+            text = lines.isEmpty() ? QString() : lines.join('\n') + '\n';
+        }
+        else
+        {
+            // the last line doesn't end with a line break, so replace the line break before the hunk instead
+            end = document->characterCount() - 1;
+            if (hunk.oldStart > 0)
+            {
+                auto block = document->findBlockByNumber(hunk.oldStart - 1);
+                start = block.position() + block.length() - 1;
+                text = lines.isEmpty() ? QString() : '\n' + lines.join('\n');
+            }
+            else
+            {
+                text = lines.join('\n');
+            }
+        }
+        cursor.setPosition(start);
+        cursor.setPosition(end, QTextCursor::KeepAnchor);
+        cursor.insertText(text);
+    }
+    cursor.endEditBlock();
+
+    auto newTextCursor = m_editor->textCursor();
+    newTextCursor.setPosition(document->findBlockByNumber(newAnchor.first).position() + newAnchor.second);
+    newTextCursor.setPosition(document->findBlockByNumber(newCursor.first).position() + newCursor.second,
+                              QTextCursor::KeepAnchor);
+    m_editor->setTextCursor(newTextCursor);
+
+    m_editor->horizontalScrollBar()->setValue(horizontalScroll);
+    m_editor->verticalScrollBar()->setValue(verticalScroll);
+}
+
+void CodeFormatter::finish()
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+    if (m_timer != nullptr)
+        m_timer->stop();
+    emit finished();
+    deleteLater();
+}
+
+FormatterWorker *CodeFormatter::worker() const
+{
+    return nullptr;
+}
+
+QJsonObject CodeFormatter::workerRequest(const QString &, const QString &) const
+{
+    return {};
 }
 
 bool CodeFormatter::formatSelectionOnly() const
@@ -15,17 +15,31 @@
  *
  */
 
+/*
+ * The CodeFormatter runs a formatter program on the code in an editor, and applies the result as a minimal edit.
+ * It runs asynchronously by default: the result is applied only if the code is not changed while formatting, and the
+ * formatter deletes itself when it's finished.
+ * The source files and the style file are written to a temporary workspace shared by all formatters.
+ * A formatter can provide a FormatterWorker, then the code is sent to the long-lived worker instead of starting a new
+ * process for each format.
+ */
+
 #ifndef CODEFORMATTER_HPP
 #define CODEFORMATTER_HPP
 
 #include "Editor/CodeEditor.hpp"
+#include <QJsonObject>
 #include <QObject>
+#include <QPointer>
 
 class MessageLogger;
-class QTextCursor;
+class QProcess;
+class QTimer;
 
 namespace Extensions
 {
+class FormatterWorker;
+
 class CodeFormatter : public QObject
 {
     Q_OBJECT
@@ -34,7 +48,20 @@ class CodeFormatter : public QObject
     explicit CodeFormatter(Editor::CodeEditor *editor, const QString &lang, bool selectionOnly, bool logOnNoChange,
                            MessageLogger *log, QObject *parent = nullptr);
 
-    void format() const;
+    ~CodeFormatter() override;
+
+    /**
+     * @brief start formatting
+     * @param wait whether to wait until the result is applied, otherwise it returns immediately
+     * @note The formatter is deleted later when it's finished, whether it waits or not.
+     */
+    void format(bool wait = false);
+
+  signals:
+    /**
+     * @brief the formatting is finished, whether it succeeded or not
+     */
+    void finished();
 
   protected:
     /**
@@ -66,36 +93,71 @@ class CodeFormatter : public QObject
     virtual QString newSource(const QString &out) const = 0;
 
     /**
-     * @brief the new text cursor after formatting
-     * @param out the stdout of the format process
-     * @param args the arguments used when formatting
+     * @brief the worker used to format the code, or nullptr to start a new format process
      */
-    virtual QTextCursor newCursor(const QString &out, const QStringList &args) const = 0;
+    virtual FormatterWorker *worker() const;
 
     /**
-     * @brief run the format process and get the result
-     * @param args the arguments of the format process
-     * @returns the stdout of the format process, or an empty QString if error occurred
+     * @brief the request sent to the worker
+     * @param source the code to format
+     * @param stylePath the path to the style file, or an empty string if the style is empty
+     * @note you can use cursorPos, cursorLine, cursorCol, anchorPos, anchorLine, anchorCol in this function
      */
-    QString runProcess(const QStringList &args) const;
+    virtual QJsonObject workerRequest(const QString &source, const QString &stylePath) const;
 
     /**
      * @brief check whether only the selection is formatted
      */
     bool formatSelectionOnly() const;
 
-  private:
     /**
      * @brief get settingKey()/key
      */
     QVariant getSetting(const QString &key) const;
 
+  private slots:
+    void onProcessFinished();
+    void onProcessFailedToStart();
+    void onTimeout();
+    void onWorkerResponded(int id, const QJsonObject &response);
+
+  private:
+    /**
+     * @brief send the code to the worker instead of starting a new process
+     */
+    void formatWithWorker(FormatterWorker *worker, const QString &stylePath, bool wait);
+
+    /**
+     * @brief apply the output of the formatter if the code is not changed while formatting
+     */
+    void onFormatted(const QString &out);
+
+    /**
+     * @brief replace the code in the editor by the changed lines only, and keep the cursor on the same lines
+     */
+    void applySource(const QString &source);
+
+    /**
+     * @brief finish formatting and delete the formatter later
+     */
+    void finish();
+
+    const static int FORMAT_TIMEOUT = 2000; // the time limit of the format process (ms)
+
   private:
-    Editor::CodeEditor *m_editor;
+    QPointer<Editor::CodeEditor> m_editor;
     QString m_lang;
     bool m_selectionOnly;
     bool m_logOnNoChange;
     int m_cursorPos, m_cursorLine, m_cursorCol, m_anchorPos, m_anchorLine, m_anchorCol;
+    int m_revision;       // the revision of the document when formatting is started
+    QString m_text;       // the code when formatting is started
+    QString m_sourcePath; // the path to the source file in the workspace
+    QProcess *m_process = nullptr;
+    QPointer<FormatterWorker> m_worker;
+    int m_requestId = -1; // the id of the request sent to m_worker
+    QTimer *m_timer = nullptr;
+    bool m_finished = false;
 
   protected:
     Editor::CodeEditor *editor() const
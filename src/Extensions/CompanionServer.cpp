@@ -17,14 +17,22 @@
 
 #include "Extensions/CompanionServer.hpp"
 #include "Core/EventLogger.hpp"
+#include "Core/Judge.hpp"
 #include "Core/MessageLogger.hpp"
+#include "Core/StartupTracer.hpp"
+#include "Util/FileUtil.hpp"
+#include "Widgets/TestCases.hpp"
+#include "generated/SettingsHelper.hpp"
 #include "third_party/qhttp/src/qhttpfwd.hpp"
 #include "third_party/qhttp/src/qhttpserver.hpp"
 #include "third_party/qhttp/src/qhttpserverconnection.hpp"
 #include "third_party/qhttp/src/qhttpserverrequest.hpp"
 #include "third_party/qhttp/src/qhttpserverresponse.hpp"
+#include <QFileInfo>
+#include <QHostAddress>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QPointer>
 
 #define USER_INFO(x)                                                                                                   \
     if (log)                                                                                                           \
@@ -40,9 +48,12 @@
 
 namespace Extensions
 {
+static const char *const API_PREFIX = "/api/"; // the requests to this path are handled by the local API
+
 CompanionServer::CompanionServer(int port, QObject *parent) : QObject(parent)
 {
-    if (startListeningOn(port))
+    TRACE_STARTUP("CompanionServer::CompanionServer");
+    if (port != 0 && startListeningOn(port)) // port 0 means closed, the same as in updatePort()
     {
         lastListeningPort = port;
     }
@@ -58,13 +69,28 @@ bool CompanionServer::startListeningOn(int port)
     delete server;
     server = new qhttp::server::QHttpServer(this);
     server->listen(QString::number(port), [this](qhttp::server::QHttpRequest *req, qhttp::server::QHttpResponse *res) {
-        LOG_INFO("\n--> " << req->methodString() << " : " << qPrintable(req->url().toString().toUtf8()));
+        LOG_DEBUG("\n--> " << req->methodString() << " : " << qPrintable(req->url().toString().toUtf8()));
         req->headers().forEach(
-            [](auto iter) { LOG_INFO(iter.key().constData() << " : " << iter.value().constData()); });
+            [](auto iter) { LOG_DEBUG(iter.key().constData() << " : " << iter.value().constData()); });
 
         const QString methodType = req->methodString();
         const bool isJson = req->headers().keyHasValue("content-type", "application/json");
-        req->collectData();
+        const auto contentLength = req->headers().value("content-length");
+
+        if (!contentLength.isEmpty() && contentLength.toLongLong() > MAX_PAYLOAD_SIZE)
+        {
+            LOG_WARN("The request is too large " << INFO_OF(contentLength));
+            USER_ERR(tr("The request received is too large (%1 bytes). The limit is %2 bytes.")
+                         .arg(QString::fromLatin1(contentLength))
+                         .arg(MAX_PAYLOAD_SIZE));
+            res->addHeader("connection", "close");
+            res->setStatusCode(qhttp::ESTATUS_REQUEST_ENTITY_TOO_LARGE);
+            res->end();
+            return;
+        }
+
+        // the connection is closed if the body without a content-length header exceeds the limit
+        req->collectData(MAX_PAYLOAD_SIZE);
 
         req->onEnd([res, methodType, this, isJson, req] {
             res->addHeader("connection", "close");
@@ -78,13 +104,17 @@ bool CompanionServer::startListeningOn(int port)
             {
                 USER_ERR(tr("The request received is not JSON"));
             }
+            else if (req->url().path().startsWith(API_PREFIX))
+            {
+                handleApiRequest(req->url().path(), req->remoteAddress(), req->headers().value("host"),
+                                 req->collectedData(), res);
+                return;
+            }
             else
             {
                 res->setStatusCode(qhttp::ESTATUS_ACCEPTED);
-                QByteArray data = req->collectedData();
-                LOG_INFO(INFO_OF(data));
                 res->end();
-                parseAndEmit(data);
+                parseAndEmit(req->collectedData());
                 return;
             }
 
@@ -122,33 +152,138 @@ void CompanionServer::updatePort(int port)
     }
 }
 
-void CompanionServer::parseAndEmit(QByteArray &data)
+void CompanionServer::parseAndEmit(const QByteArray &data)
 {
     QJsonParseError error{};
-    QJsonDocument doc = QJsonDocument::fromJson(QString(data).toUtf8(), &error);
-    if (error.error == QJsonParseError::NoError)
+    auto doc = QJsonDocument::fromJson(data, &error);
+    if (error.error != QJsonParseError::NoError)
     {
-        CompanionData payload;
+        USER_ERR(tr("JSON parser reported errors:\n%1").arg(error.errorString()));
+        LOG_WARN("JSON parser reported error " << error.errorString() << INFO_OF(data.size()));
+        return;
+    }
 
-        payload.doc = doc;
-        payload.url = doc["url"].toString();
-        payload.timeLimit = doc["timeLimit"].toInt();
-        QJsonArray testArray = doc["tests"].toArray();
+    const auto invalid = [this, &data](const QString &reason) {
+        USER_ERR(tr("The request received is not a valid problem: %1").arg(reason));
+        LOG_WARN("Invalid payload: " << reason << INFO_OF(data.size()));
+    };
 
-        for (auto tests : testArray)
-        {
-            auto in = tests.toObject()["input"].toString();
-            auto out = tests.toObject()["output"].toString();
-            payload.testcases.push_back({in, out});
-        }
+    if (!doc.isObject())
+        return invalid(tr("the payload is not a JSON object"));
+
+    const auto root = doc.object();
+    const auto url = root["url"];
+    const auto timeLimit = root["timeLimit"];
+    const auto tests = root["tests"];
+
+    if (!url.isString() && !url.isUndefined())
+        return invalid(tr("[url] is not a string"));
+    if (!timeLimit.isDouble() && !timeLimit.isUndefined())
+        return invalid(tr("[timeLimit] is not a number"));
+    if (!tests.isArray() && !tests.isUndefined())
+        return invalid(tr("[tests] is not an array"));
+
+    CompanionData payload;
+    payload.doc = doc;
+    payload.url = url.toString();
+    payload.timeLimit = timeLimit.toInt();
+
+    const auto testArray = tests.toArray();
+    payload.testcases.reserve(qMin(testArray.size(), int(MAX_NUMBER_OF_TESTS)));
+    for (int i = 0; i < testArray.size() && i < MAX_NUMBER_OF_TESTS; ++i)
+    {
+        const auto test = testArray[i].toObject();
+        const auto input = test["input"];
+        const auto output = test["output"];
+        if (!input.isString() || (!output.isString() && !output.isUndefined()))
+            return invalid(tr("the test #%1 doesn't have string [input] and [output]").arg(i + 1));
+        payload.testcases.push_back({input.toString(), output.toString()});
+    }
+
+    LOG_INFO("Problem received " << INFO_OF(root["name"].toString()) << INFO_OF(payload.url)
+                                 << INFO_OF(payload.timeLimit) << INFO_OF(testArray.size()) << INFO_OF(data.size()));
 
-        emit onRequestArrived(payload);
+    if (testArray.size() > MAX_NUMBER_OF_TESTS)
+    {
+        USER_WARN(tr("The problem has %1 tests, only the first %2 tests are loaded.")
+                      .arg(testArray.size())
+                      .arg(MAX_NUMBER_OF_TESTS));
+    }
+
+    emit onRequestArrived(payload);
+}
+
+void CompanionServer::handleApiRequest(const QString &path, const QString &remoteAddress, const QByteArray &host,
+                                       const QByteArray &data, qhttp::server::QHttpResponse *res)
+{
+    LOG_INFO(INFO_OF(path) << INFO_OF(remoteAddress) << INFO_OF(data.size()));
+
+    QPointer<qhttp::server::QHttpResponse> response = res; // the client may close the connection before it's judged
+    const auto reply = [response](qhttp::TStatusCode status, const QJsonObject &body) {
+        if (response.isNull())
+            return;
+        response->setStatusCode(status);
+        response->addHeader("content-type", "application/json");
+        response->end(QJsonDocument(body).toJson(QJsonDocument::Compact));
+    };
+    const auto replyError = [reply](qhttp::TStatusCode status, const QString &message) {
+        reply(status, {{"status", "failed"}, {"message", message}});
+    };
+
+    if (!SettingsHelper::isCompetitiveCompanionLocalAPI())
+        return replyError(qhttp::ESTATUS_FORBIDDEN, "The local API is disabled");
+
+    // the API runs programs, so it's never available to other machines
+    if (!QHostAddress(remoteAddress).isLoopback())
+        return replyError(qhttp::ESTATUS_FORBIDDEN, "The local API is only available on this machine");
+
+    // a web page can reach the loopback address with a domain resolved to it (DNS rebinding), but the browser sends
+    // the domain in the Host header
+    const auto hostName = QString::fromLatin1(host);
+    bool isLocalHost = false;
+    for (const auto &name : {"localhost", "127.0.0.1", "[::1]"})
+    {
+        if (hostName.compare(QString("%1:%2").arg(name).arg(lastListeningPort), Qt::CaseInsensitive) == 0)
+            isLocalHost = true;
+    }
+    if (!isLocalHost)
+        return replyError(qhttp::ESTATUS_FORBIDDEN, QString("The host [%1] is not allowed").arg(hostName));
+
+    if (path != API_PREFIX + QString("judge"))
+        return replyError(qhttp::ESTATUS_NOT_FOUND, QString("Unknown API [%1]").arg(path));
+
+    QJsonParseError error{};
+    const auto request = QJsonDocument::fromJson(data, &error).object();
+    if (error.error != QJsonParseError::NoError)
+        return replyError(qhttp::ESTATUS_BAD_REQUEST, error.errorString());
+
+    const auto file = request["file"].toString();
+    if (file.isEmpty() || !QFileInfo(file).isFile())
+        return replyError(qhttp::ESTATUS_BAD_REQUEST, QString("[file] is not an existing file"));
+
+    const auto lang = request["language"].toString(Util::languageOfFile(file, QString()));
+    const int timeLimit = request["timeLimit"].toInt(SettingsHelper::getDefaultTimeLimit());
+    const auto checker = request["checker"].toString(Core::Judge::checkerNames().first());
+
+    // use the saved test cases of the file if the test cases are not given
+    QVector<Core::Judge::TestCase> testCases;
+    if (request.contains("tests"))
+    {
+        for (const auto &test : request["tests"].toArray())
+            testCases.push_back({test.toObject()["input"].toString(), test.toObject()["output"].toString()});
     }
     else
     {
-        USER_ERR(tr("JSON parser reported errors:\n%1").arg(error.errorString()));
-        LOG_WARN("JSON parser reported error " << error.errorString());
+        for (const auto &test : Widgets::TestCases::readSavedFiles(file))
+            testCases.push_back({test.first, test.second});
     }
+
+    auto *judge = new Core::Judge(this);
+    connect(judge, &Core::Judge::finished, this, [judge, reply](const QJsonObject &report) {
+        reply(qhttp::ESTATUS_OK, report);
+        judge->deleteLater();
+    });
+    judge->start(file, lang, testCases, timeLimit, checker);
 }
 
 CompanionServer::~CompanionServer()
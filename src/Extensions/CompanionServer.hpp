@@ -29,6 +29,7 @@ namespace qhttp
 namespace server
 {
 class QHttpServer;
+class QHttpResponse;
 }
 } // namespace qhttp
 
@@ -65,7 +66,24 @@ class CompanionServer : public QObject
 
   private:
     bool startListeningOn(int port);
-    void parseAndEmit(QByteArray &data);
+
+    /**
+     * @brief parse and validate the payload, and emit onRequestArrived if it's valid
+     * @note Only a summary of the payload is logged, because the tests can be large.
+     */
+    void parseAndEmit(const QByteArray &data);
+
+    /**
+     * @brief handle a request to the local API, e.g. POST /api/judge, which compiles, runs and checks a file
+     * @param host the Host header, which must be localhost, 127.0.0.1 or [::1] with the port of the server
+     * @note It's replied with a JSON object after the file is judged, see Core::Judge for the report.
+     */
+    void handleApiRequest(const QString &path, const QString &remoteAddress, const QByteArray &host,
+                          const QByteArray &data, qhttp::server::QHttpResponse *res);
+
+    const static int MAX_PAYLOAD_SIZE = 32 * 1024 * 1024; // the maximum size of the request body (bytes)
+    const static int MAX_NUMBER_OF_TESTS = 100;           // the tests after this are ignored, as in TestCases
+
     qhttp::server::QHttpServer *server = nullptr;
     int lastListeningPort = -1;
     MessageLogger *log = nullptr;
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Extensions/FormatterWorker.hpp"
+#include "Core/EventLogger.hpp"
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QJsonDocument>
+
+namespace Extensions
+{
+
+FormatterWorker *FormatterWorker::instance(const QString &name, const QString &program, const QStringList &arguments)
+{
+    static QHash<QString, FormatterWorker *> workers;
+
+    auto *&worker = workers[name];
+    if (worker == nullptr)
+        worker = new FormatterWorker(qApp);
+
+    if (worker->program != program || worker->arguments != arguments)
+    {
+        LOG_INFO(INFO_OF(name) << INFO_OF(program) << INFO_OF(arguments.join(' ')));
+        worker->kill();
+        worker->program = program;
+        worker->arguments = arguments;
+    }
+
+    return worker;
+}
+
+FormatterWorker::FormatterWorker(QObject *parent) : QObject(parent)
+{
+}
+
+FormatterWorker::~FormatterWorker()
+{
+    kill();
+}
+
+int FormatterWorker::request(QJsonObject request)
+{
+    const int id = nextId++;
+    request["id"] = id;
+
+    if (process == nullptr)
+    {
+        LOG_INFO("Starting formatter worker " << INFO_OF(program) << INFO_OF(arguments.join(' ')));
+        outputBuffer.clear();
+        errorOutput.clear();
+        auto *current = new QProcess(this);
+        process = current;
+        connect(current, &QProcess::readyReadStandardOutput, this, &FormatterWorker::onReadyReadStandardOutput);
+        connect(current, &QProcess::readyReadStandardError, this, &FormatterWorker::onReadyReadStandardError);
+        connect(current, &QProcess::errorOccurred, this, &FormatterWorker::onErrorOccurred);
+        connect(current, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+                &FormatterWorker::onFinished);
+        current->start(program, arguments);
+
+        // start() may fail synchronously, e.g. if the program is empty, then onErrorOccurred() has reset the process
+        if (process != current)
+        {
+            // the caller gets the id after this returns, so the response can't be emitted here
+            failedRequests.push_back({{"id", id}, {"error", current->errorString()}, {"failedToStart", true}});
+            QMetaObject::invokeMethod(this, &FormatterWorker::emitFailedRequests, Qt::QueuedConnection);
+            return id;
+        }
+    }
+
+    pendingIds.insert(id);
+    // the data is buffered by QProcess until the process is started
+    process->write(QJsonDocument(request).toJson(QJsonDocument::Compact) + '\n');
+    return id;
+}
+
+bool FormatterWorker::waitForReadyRead(int msecs)
+{
+    if (process == nullptr)
+    {
+        if (failedRequests.isEmpty())
+            return false;
+        emitFailedRequests();
+        return true;
+    }
+    // the process may be deleted in the slots connected to its signals
+    auto *current = process;
+    QDeadlineTimer deadline(msecs);
+    if (current->state() == QProcess::Starting && !current->waitForStarted(msecs))
+        return false;
+    return current == process && current->waitForReadyRead(int(deadline.remainingTime()));
+}
+
+void FormatterWorker::kill()
+{
+    if (process == nullptr)
+        return;
+    auto *current = process;
+    process = nullptr;
+    current->disconnect(this);
+    if (current->state() != QProcess::NotRunning)
+    {
+        current->kill();
+        current->waitForFinished(100);
+    }
+    current->deleteLater();
+    failPendingRequests({{"error", tr("The formatter worker is killed")}});
+}
+
+void FormatterWorker::onReadyReadStandardOutput()
+{
+    outputBuffer.append(process->readAllStandardOutput());
+
+    int lineStart = 0;
+    int lineEnd;
+    while ((lineEnd = outputBuffer.indexOf('\n', lineStart)) != -1)
+    {
+        const auto line = outputBuffer.mid(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+
+        QJsonParseError error;
+        const auto response = QJsonDocument::fromJson(line, &error).object();
+        if (error.error != QJsonParseError::NoError || !response.contains("id"))
+        {
+            LOG_WARN("Invalid response from the formatter worker: " << error.errorString());
+            continue;
+        }
+        const int id = response["id"].toInt();
+        if (pendingIds.remove(id))
+            emit responded(id, response);
+    }
+    outputBuffer.remove(0, lineStart);
+}
+
+void FormatterWorker::onReadyReadStandardError()
+{
+    errorOutput.append(process->readAllStandardError());
+    if (errorOutput.size() > MAX_ERROR_OUTPUT)
+        errorOutput.remove(0, errorOutput.size() - MAX_ERROR_OUTPUT);
+}
+
+void FormatterWorker::onErrorOccurred(QProcess::ProcessError error)
+{
+    if (error != QProcess::FailedToStart)
+        return;
+    LOG_WARN("Failed to start the formatter worker " << INFO_OF(program));
+    auto *current = process;
+    process = nullptr;
+    current->deleteLater();
+    failPendingRequests({{"error", current->errorString()}, {"failedToStart", true}});
+}
+
+void FormatterWorker::onFinished()
+{
+    LOG_WARN("The formatter worker exited " << INFO_OF(process->exitCode()));
+    // read the responses written before exiting
+    onReadyReadStandardOutput();
+    onReadyReadStandardError();
+    auto *current = process;
+    process = nullptr;
+    current->deleteLater();
+    failPendingRequests({{"error", tr("The formatter worker exited with exit code %1: %2")
+                                       .arg(current->exitCode())
+                                       .arg(QString::fromUtf8(errorOutput).trimmed())}});
+}
+
+void FormatterWorker::emitFailedRequests()
+{
+    const auto responses = failedRequests;
+    failedRequests.clear();
+    for (const auto &response : responses)
+        emit responded(response["id"].toInt(), response);
+}
+
+void FormatterWorker::failPendingRequests(QJsonObject response)
+{
+    const auto ids = pendingIds;
+    pendingIds.clear();
+    for (int id : ids)
+    {
+        response["id"] = id;
+        emit responded(id, response);
+    }
+}
+
+} // namespace Extensions
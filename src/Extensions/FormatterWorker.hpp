@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+/*
+ * The FormatterWorker is a long-lived formatter process which formats code on request, so that the cost of starting
+ * the formatter is paid only once instead of on every format.
+ * The requests and the responses are JSON objects, one per line. Each request is given an "id", which is copied to
+ * the response. A response with an "error" means the request failed, otherwise it has the formatted "source".
+ * The process is started on the first request, and restarted on the next request if it exits.
+ */
+
+#ifndef FORMATTERWORKER_HPP
+#define FORMATTERWORKER_HPP
+
+#include <QJsonObject>
+#include <QObject>
+#include <QProcess>
+#include <QSet>
+#include <QVector>
+
+namespace Extensions
+{
+class FormatterWorker : public QObject
+{
+    Q_OBJECT
+
+  public:
+    /**
+     * @brief get the worker with the given name
+     * @note The worker is restarted if the program or the arguments are different from the running one.
+     */
+    static FormatterWorker *instance(const QString &name, const QString &program, const QStringList &arguments);
+
+    ~FormatterWorker() override;
+
+    /**
+     * @brief send a request to the worker, starting the worker if it's not running
+     * @returns the id of the request, which is the id of the response
+     * @note The response is never emitted before this returns, even if the worker fails to start immediately.
+     */
+    int request(QJsonObject request);
+
+    /**
+     * @brief wait until there is new output or the worker exits, the responses are emitted in this function
+     * @returns false if the worker is not running or it times out
+     * @note The responses to the requests that failed to start the worker are emitted here if they are not yet.
+     */
+    bool waitForReadyRead(int msecs);
+
+    /**
+     * @brief kill the worker, the pending requests fail
+     * @note It's used when a request times out, because the worker may be stuck.
+     */
+    void kill();
+
+  signals:
+    /**
+     * @brief the response to the request with the given id
+     * @note The response has "failedToStart" set to true if the worker can't be started.
+     */
+    void responded(int id, const QJsonObject &response);
+
+  private slots:
+    void onReadyReadStandardOutput();
+    void onReadyReadStandardError();
+    void onErrorOccurred(QProcess::ProcessError error);
+    void onFinished();
+    void emitFailedRequests();
+
+  private:
+    explicit FormatterWorker(QObject *parent = nullptr);
+
+    /**
+     * @brief fail all pending requests with the given response
+     */
+    void failPendingRequests(QJsonObject response);
+
+    const static int MAX_ERROR_OUTPUT = 4096; // the maximum size of the stderr kept for error messages
+
+  private:
+    QProcess *process = nullptr;
+    QString program;
+    QStringList arguments;
+    QByteArray outputBuffer;             // the stdout which is not a complete line yet
+    QByteArray errorOutput;              // the last part of the stderr
+    QVector<QJsonObject> failedRequests; // the responses to the requests that failed before request() returned
+    QSet<int> pendingIds;
+    int nextId = 0;
+};
+} // namespace Extensions
+
+#endif // FORMATTERWORKER_HPP
@@ -17,8 +17,10 @@
 #include "LanguageServer.hpp"
 #include "Core/EventLogger.hpp"
 #include "Core/MessageLogger.hpp"
+#include "Core/StartupTracer.hpp"
 #include "Settings/SettingsManager.hpp"
 #include "Util/Util.hpp"
+#include "generated/SettingsHelper.hpp"
 #include "third_party/lsp-cpp/include/LSPClient.hpp"
 #include <QDir>
 #include <QFileInfo>
@@ -30,6 +32,7 @@ namespace Extensions
 
 LanguageServer::LanguageServer(QString const &lang)
 {
+    TRACE_STARTUP("LanguageServer::LanguageServer", lang);
     LOG_INFO(INFO_OF(lang));
     this->language = lang;
     if (shouldCreateClient())
@@ -37,6 +40,21 @@ LanguageServer::LanguageServer(QString const &lang)
         createClient();
         performConnection();
     }
+
+    // restart the server only when the settings used to start it are changed
+    using SettingsHelper::Key;
+    if (lang == "C++")
+        SettingsManager::subscribe(
+            this, {Key::LSPPathCpp, Key::LSPArgsCpp, Key::LSPUseLintingCpp, Key::LSPUseAutocompleteCpp},
+            [this] { updateSettings(); });
+    else if (lang == "Java")
+        SettingsManager::subscribe(
+            this, {Key::LSPPathJava, Key::LSPArgsJava, Key::LSPUseLintingJava, Key::LSPUseAutocompleteJava},
+            [this] { updateSettings(); });
+    else if (lang == "Python")
+        SettingsManager::subscribe(
+            this, {Key::LSPPathPython, Key::LSPArgsPython, Key::LSPUseLintingPython, Key::LSPUseAutocompletePython},
+            [this] { updateSettings(); });
 }
 
 LanguageServer::~LanguageServer()
@@ -261,13 +279,13 @@ void LanguageServer::onLSPServerNotificationArrived(QString const &method, QJson
 void LanguageServer::onLSPServerResponseArrived(QJsonObject const &method, // NOLINT: It can be made static.
                                                 QJsonObject const &param)
 {
-    LOG_INFO("Response from Server has arrived");
+    LOG_DEBUG("Response from Server has arrived");
 }
 
 void LanguageServer::onLSPServerRequestArrived(QString const &method, // NOLINT: It can be made static.
                                                QJsonObject const &param, QJsonObject const &id)
 {
-    LOG_INFO("Request from Sever has arrived. " << INFO_OF(method));
+    LOG_DEBUG("Request from Sever has arrived. " << INFO_OF(method));
 }
 
 void LanguageServer::onLSPServerErrorArrived(QJsonObject const &id, QJsonObject const &error)
@@ -324,6 +342,6 @@ void LanguageServer::onLSPServerProcessFinished(int exitCode, QProcess::ExitStat
 
 void LanguageServer::onLSPServerNewStderr(const QString &content) // NOLINT: It can be made static
 {
-    LOG_INFO(content);
+    LOG_DEBUG(content);
 }
 } // namespace Extensions
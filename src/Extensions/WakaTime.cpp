@@ -17,6 +17,7 @@
 
 #include "Extensions/WakaTime.hpp"
 #include "Core/EventLogger.hpp"
+#include "Core/StartupTracer.hpp"
 #include "generated/SettingsHelper.hpp"
 #include "generated/version.hpp"
 #include <QProcess>
@@ -27,6 +28,7 @@ namespace Extensions
 
 WakaTime::WakaTime(QObject *parent) : QObject(parent)
 {
+    TRACE_STARTUP("WakaTime::WakaTime");
     debounce = new QTimer(this);
     debounce->setSingleShot(true);
     debounce->setInterval(200);
@@ -16,14 +16,32 @@
  */
 
 #include "Extensions/YAPFormatter.hpp"
-#include "Editor/CodeEditor.hpp"
-#include <QTextBlock>
-#include <QTextCursor>
-#include <QTextDocument>
+#include "Extensions/FormatterWorker.hpp"
+#include <QJsonArray>
+#include <QProcess>
 
 namespace Extensions
 {
 
+/**
+ * @brief the Python script of the YAPF worker, it formats the code in each request line by yapf_api.FormatCode
+ * @note yapf is imported only once, which is the most time-consuming part of running yapf.
+ */
+static const char *const YAPF_WORKER_SCRIPT = R"(
+import io, json, sys
+from yapf.yapflib.yapf_api import FormatCode
+stdin = io.TextIOWrapper(sys.stdin.buffer, encoding='utf-8')
+for line in stdin:
+    request = json.loads(line)
+    try:
+        result = FormatCode(request['source'], style_config=request.get('style'), lines=request.get('lines'))
+        response = {'id': request['id'], 'source': result[0] if isinstance(result, tuple) else result}
+    except Exception as e:
+        response = {'id': request['id'], 'error': '%s: %s' % (type(e).__name__, e)}
+    sys.stdout.write(json.dumps(response) + '\n')
+    sys.stdout.flush()
+)";
+
 YAPFormatter::YAPFormatter(Editor::CodeEditor *editor, const QString &lang, bool selectionOnly, bool logOnNoChange,
                            MessageLogger *log, QObject *parent)
     : CodeFormatter(editor, lang, selectionOnly, logOnNoChange, log, parent)
@@ -55,35 +73,25 @@ QString YAPFormatter::newSource(const QString &out) const
     return out;
 }
 
-QTextCursor YAPFormatter::newCursor(const QString &out, const QStringList & /*args*/) const
+FormatterWorker *YAPFormatter::worker() const
 {
-    auto cursor = editor()->textCursor();
-
-    auto setCol = [this, &cursor](QTextCursor::MoveMode mode, int col) {
-        cursor.movePosition(QTextCursor::NextCharacter, mode,
-                            qMin(col, editor()->document()->findBlockByNumber(cursor.blockNumber()).length() - 1));
-    };
-
-    cursor.movePosition(QTextCursor::Start);
-    cursor.movePosition(QTextCursor::NextBlock, QTextCursor::MoveAnchor, anchorLine());
-    setCol(QTextCursor::MoveAnchor, anchorCol());
-
-    if (cursorPos() == anchorPos())
-        return cursor;
-
-    if (anchorLine() <= cursorLine())
-    {
-        cursor.movePosition(QTextCursor::NextBlock, QTextCursor::KeepAnchor, cursorLine() - anchorLine());
-    }
-    else
-    {
-        cursor.movePosition(QTextCursor::PreviousBlock, QTextCursor::KeepAnchor, anchorLine() - cursorLine());
-        cursor.movePosition(QTextCursor::StartOfBlock, QTextCursor::KeepAnchor);
-    }
-
-    setCol(QTextCursor::KeepAnchor, cursorCol());
+    // the worker runs yapf as a module, so it's used only when the program is a Python interpreter running yapf
+    // without other arguments, which is the default setting
+    if (QProcess::splitCommand(getSetting("Arguments").toString()) != QStringList{"-m", "yapf"})
+        return nullptr;
+    return FormatterWorker::instance(settingKey(), getSetting("Program").toString(),
+                                     {"-u", "-c", QString(YAPF_WORKER_SCRIPT).trimmed()});
+}
 
-    return cursor;
+QJsonObject YAPFormatter::workerRequest(const QString &source, const QString &stylePath) const
+{
+    QJsonObject request{{"source", source}};
+    if (!stylePath.isEmpty())
+        request["style"] = stylePath;
+    if (formatSelectionOnly())
+        request["lines"] = QJsonArray{QJsonArray{qMin(cursorLine(), anchorLine()) + 1,
+                                                 qMax(cursorLine(), anchorLine()) + 1}};
+    return request;
 }
 
 } // namespace Extensions
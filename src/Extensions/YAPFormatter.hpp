@@ -41,7 +41,9 @@ class YAPFormatter : public CodeFormatter
 
     QString newSource(const QString &out) const override;
 
-    QTextCursor newCursor(const QString &out, const QStringList & /*args*/) const override;
+    FormatterWorker *worker() const override;
+
+    QJsonObject workerRequest(const QString &source, const QString &stylePath) const override;
 };
 
 } // namespace Extensions
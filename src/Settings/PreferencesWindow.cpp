@@ -17,6 +17,7 @@
 
 #include "Settings/PreferencesWindow.hpp"
 #include "Core/EventLogger.hpp"
+#include "Core/StartupTracer.hpp"
 #include "Settings/CodeSnippetsPage.hpp"
 #include "Settings/DefaultPathManager.hpp"
 #include "Settings/ParenthesesPage.hpp"
@@ -125,6 +126,7 @@ AddPageHelper::AddPageHelper(PreferencesWindow *w) : window(w), tree(window->men
 
 PreferencesWindow::PreferencesWindow(QWidget *parent) : QMainWindow(parent)
 {
+    TRACE_STARTUP("PreferencesWindow::PreferencesWindow");
     // set attributes
     hide();
     setWindowTitle(tr("Preferences"));
@@ -263,7 +265,7 @@ PreferencesWindow::PreferencesWindow(QWidget *parent) : QMainWindow(parent)
             .page(TRKEY("Competitive Companion"), {"Competitive Companion/Enable", "Competitive Companion/Open New Tab",
                 "Competitive Companion/Set Time Limit For Tab", "Competitive Companion/Connection Port",
                 "Competitive Companion/Head Comments", "Competitive Companion/Head Comments Time Format",
-                "Competitive Companion/Head Comments Powered By CP Editor"}, false)
+                "Competitive Companion/Head Comments Powered By CP Editor", "Competitive Companion/Local API"}, false)
             .page(TRKEY("CF Tool"), {"CF/Enable","CF/Path", "CF/Show Toast Messages"})
             .page(TRKEY("WakaTime"),{"WakaTime/Enable", "WakaTime/Path", "WakaTime/Api Key", "WakaTime/Proxy"})
         .end()
@@ -277,7 +279,7 @@ PreferencesWindow::PreferencesWindow(QWidget *parent) : QMainWindow(parent)
         .dir(TRKEY("Advanced"))
             .page(TRKEY("Update"), {"Check Update", "Beta"})
             .page(TRKEY("Limits"), {"Default Time Limit", "Output Length Limit", "Output Display Length Limit", "Message Length Limit",
-                                    "HTML Diff Viewer Length Limit", "Open File Length Limit", "Display Test Case Length Limit"})
+                                    "Message Count Limit", "HTML Diff Viewer Length Limit", "Open File Length Limit", "Display Test Case Length Limit"})
             .page(TRKEY("Network Proxy"), {"Proxy/Enabled", "Proxy/Type", "Proxy/Host Name", "Proxy/Port", "Proxy/User", "Proxy/Password"})
         .end()
     .ensureAtTop();
@@ -17,15 +17,20 @@
 
 #include "Settings/SettingsManager.hpp"
 #include "Core/EventLogger.hpp"
+#include "Core/StartupTracer.hpp"
 #include "Settings/FileProblemBinder.hpp"
 #include "Settings/SettingsUpdater.hpp"
 #include "Util/FileUtil.hpp"
+#include "generated/SettingsHelper.hpp"
 #include "generated/portable.hpp"
 #include <QDateTime>
 #include <QFile>
 #include <QFont>
+#include <QPointer>
 #include <QRect>
 #include <QSettings>
+#include <QTimer>
+#include <memory>
 
 QVariantMap *SettingsManager::cur = nullptr;
 QVariantMap *SettingsManager::def = nullptr;
@@ -43,6 +48,16 @@ const static QStringList configFileLocations = {
 
 static const QStringList noUnknownKeyWarning = {"C++/Run Command", "Python/Compile Command"};
 
+struct SettingsSubscription
+{
+    QPointer<QObject> context;
+    QVector<SettingsHelper::Key> keys;
+    std::function<void()> callback;
+    bool pending = false; // whether the callback is already scheduled
+};
+
+static QList<std::shared_ptr<SettingsSubscription>> subscriptions;
+
 void SettingsManager::load(QSettings &setting, const QString &prefix, const QList<SettingsInfo::SettingInfo> &infos)
 {
     for (const auto &si : infos)
@@ -93,8 +108,29 @@ void SettingsManager::save(QSettings &setting, const QString &prefix, const QLis
             setting.setValue(QString("%1%2").arg(prefix, si.key()), get(si.name));
 }
 
+void SettingsManager::notifyChanged(const QString &key)
+{
+    const auto settingKey = SettingsHelper::keyOf(key);
+    if (settingKey == SettingsHelper::Key::Count)
+        return;
+
+    SettingsHelper::updateValue(settingKey);
+
+    for (const auto &subscription : subscriptions)
+    {
+        if (subscription->pending || !subscription->keys.contains(settingKey))
+            continue;
+        subscription->pending = true;
+        QTimer::singleShot(0, subscription->context, [subscription] {
+            subscription->pending = false;
+            subscription->callback();
+        });
+    }
+}
+
 void SettingsManager::init()
 {
+    TRACE_STARTUP("SettingsManager::init");
     delete cur;
     delete def;
     delete settingPath;
@@ -142,6 +178,8 @@ void SettingsManager::generateDefaultSettings()
     for (const auto &si : SettingsInfo::getSettings())
         def->insert(si.name, si.def);
 
+    SettingsHelper::updateValues();
+
     LOG_INFO("Default settings are generated")
 }
 
@@ -198,18 +236,30 @@ void SettingsManager::set(const QString &key, QVariant const &value)
 {
     if (!key.startsWith("Language Config/") && key != "WakaTime/Api Key")
         LOG_INFO(INFO_OF(key) << INFO_OF(value.toString()));
+    const bool changed = cur->contains(key) ? cur->value(key) != value : def->value(key) != value;
     cur->insert(key, value);
+    if (changed)
+        notifyChanged(key);
 }
 
 void SettingsManager::remove(QStringList const &keys)
 {
     for (const QString &key : keys)
-        cur->remove(key);
+    {
+        if (cur->contains(key) && cur->take(key) != def->value(key))
+            notifyChanged(key);
+    }
 }
 
 void SettingsManager::reset()
 {
+    const auto old = *cur;
     *cur = *def;
+    for (auto it = old.cbegin(); it != old.cend(); ++it)
+    {
+        if (it.value() != def->value(it.key()))
+            notifyChanged(it.key());
+    }
 }
 
 void SettingsManager::setPath(const QString &key, const QString &path, const QString &trPath)
@@ -283,3 +333,15 @@ QStringList SettingsManager::itemUnder(const QString &head)
     temp.erase(std::unique(temp.begin(), temp.end()), temp.end());
     return temp;
 }
+
+void SettingsManager::subscribe(QObject *context, const QVector<SettingsHelper::Key> &keys,
+                                const std::function<void()> &callback)
+{
+    auto subscription = std::make_shared<SettingsSubscription>();
+    subscription->context = context;
+    subscription->keys = keys;
+    subscription->callback = callback;
+    subscriptions.push_back(subscription);
+
+    QObject::connect(context, &QObject::destroyed, [subscription] { subscriptions.removeOne(subscription); });
+}
@@ -19,15 +19,28 @@
 #define SETTINGSMANAGER_HPP
 
 #include "Settings/SettingsInfo.hpp"
+#include <functional>
 
+class QObject;
 class QSettings;
 
+namespace SettingsHelper
+{
+enum class Key : int;
+}
+
 class SettingsManager
 {
   private:
     static void load(QSettings &setting, const QString &prefix, const QList<SettingsInfo::SettingInfo> &infos);
     static void save(QSettings &setting, const QString &prefix, const QList<SettingsInfo::SettingInfo> &infos);
 
+    /**
+     * @brief update SettingsHelper::values and notify the subscribers after a setting is changed
+     * @param key the name of the setting
+     */
+    static void notifyChanged(const QString &key);
+
   public:
     static void init();
     static void deinit();
@@ -69,6 +82,17 @@ class SettingsManager
     static QStringList keyStartsWith(const QString &head);
     static QStringList itemUnder(const QString &head);
 
+    /**
+     * @brief call a function after some of the settings are changed
+     * @param context the function won't be called after the context is destroyed
+     * @param keys the settings to observe, only the top-level settings can be observed
+     * @param callback called in the next event loop iteration, once no matter how many of the settings are changed
+     * @note Only the settings whose values are actually changed are notified, so it's cheaper and more precise than
+     * reacting to PreferencesWindow::settingsApplied, which is emitted for a whole page.
+     */
+    static void subscribe(QObject *context, const QVector<SettingsHelper::Key> &keys,
+                          const std::function<void()> &callback);
+
   private:
     static QVariantMap *cur;
     static QVariantMap *def;
@@ -32,16 +32,122 @@ def writeHelper(f, obj, pre, indent):
         else:
             f.write(
                 f"{ids}inline void set{key}({typename} value) {{ SettingsManager::set({json.dumps(name)}, value); }}\n")
+            # the settings in an Object have dynamic keys, only the top-level ones have typed slots in Values
+            if pre == "":
+                value = f"values.{key}"
+            else:
+                value = f"SettingsManager::get({json.dumps(name)}).value<{typename}>()"
             if typename == "bool":
-                f.write(
-                    f"{ids}inline bool is{key}() {{ return SettingsManager::get({json.dumps(name)}).toBool(); }}\n")
+                f.write(f"{ids}inline bool is{key}() {{ return {value}; }}\n")
             else:
-                f.write(
-                    f"{ids}inline {typename} get{key}() {{ return SettingsManager::get({json.dumps(name)}).value<{typename}>(); }}\n")
+                f.write(f"{ids}inline {typename} get{key}() {{ return {value}; }}\n")
         f.write(
             f"{ids}inline QString pathOf{key}(bool parent = false) {{ return SettingsManager::getPathText({json.dumps(name)}, parent); }}\n")
 
 
+def typedSettings(obj):
+    """the top-level settings with a plain type, each of them has a slot in SettingsHelper::Values"""
+    return [(t["name"], t["name"].replace(" ", "").replace("/", "").replace("+", "p"), t["type"])
+            for t in obj if t["type"] not in ["Object", "QMap"]]
+
+
+def writeValues(f, obj):
+    settings = typedSettings(obj)
+    f.write("""/**
+ * @brief the index of a setting in Values
+ */
+enum class Key : int
+{
+""")
+    for name, key, typename in settings:
+        f.write(f"    {key},\n")
+    f.write("""    Count
+};
+
+/**
+ * @brief the values of the settings, so that getting a setting is a field load instead of a QVariantMap lookup
+ * @note This is kept up to date by SettingsManager, don't modify it directly.
+ */
+struct Values
+{
+""")
+    for name, key, typename in settings:
+        f.write(f"    {typename} {key}{{}};\n")
+    f.write("""};
+
+extern Values values;
+
+/**
+ * @brief reload a setting from SettingsManager into values
+ */
+void updateValue(Key key);
+
+/**
+ * @brief reload a setting from SettingsManager into values
+ * @returns false if the setting doesn't have a slot in Values
+ */
+bool updateValue(const QString &name);
+
+/**
+ * @brief get the key of a setting by its name
+ * @returns Key::Count if the setting doesn't have a slot in Values
+ */
+Key keyOf(const QString &name);
+
+/**
+ * @brief reload all settings from SettingsManager into values
+ */
+void updateValues();
+
+""")
+
+
+def writeValuesSource(f, obj):
+    settings = typedSettings(obj)
+    f.write("""Values values;
+
+static const QHash<QString, Key> keyOfName = {
+""")
+    for name, key, typename in settings:
+        f.write(f"    {{{json.dumps(name)}, Key::{key}}},\n")
+    f.write("""};
+
+void updateValue(Key key)
+{
+    switch (key)
+    {
+""")
+    for name, key, typename in settings:
+        f.write(f"    case Key::{key}:\n")
+        f.write(f"        values.{key} = SettingsManager::get({json.dumps(name)}).value<{typename}>();\n")
+        f.write("        break;\n")
+    f.write("""    case Key::Count:
+        break;
+    }
+}
+
+bool updateValue(const QString &name)
+{
+    const auto key = keyOf(name);
+    if (key == Key::Count)
+        return false;
+    updateValue(key);
+    return true;
+}
+
+Key keyOf(const QString &name)
+{
+    return keyOfName.value(name, Key::Count);
+}
+
+void updateValues()
+{
+    for (int i = 0; i < static_cast<int>(Key::Count); ++i)
+        updateValue(static_cast<Key>(i));
+}
+""")
+
+
 def writeInfo(f, obj, lst):
     for t in obj:
         name = t["name"]
@@ -124,6 +230,7 @@ def addDefaultPaths(obj):
         ("Add Pairs Of Test Cases", "${testcase}", "testcase"),
         ("Save Test Case To A File", "${testcase}", "testcase"),
         ("Custom Checker", "${checker}", "checker"),
+        ("Interactor", "${checker}", "checker"),
         ("Export And Import Settings", "${settings}", "settings"),
         ("Export And Load Session", "${session}", "session"),
         ("Extract And Load Snippets", "${snippets}", "snippets"),
@@ -191,12 +298,27 @@ if __name__ == "__main__":
 namespace SettingsHelper
 {
 """)
+    writeValues(setting_helper, obj)
     writeHelper(setting_helper, obj, "", 1)
     setting_helper.write("""}
 
 #endif // SETTINGSHELPER_HPP""")
     setting_helper.close()
 
+    setting_helper_source = open("generated/SettingsHelper.cpp",
+                                 mode="w", encoding="utf-8")
+    setting_helper_source.write(head)
+    setting_helper_source.write("""#include "generated/SettingsHelper.hpp"
+#include <QHash>
+
+namespace SettingsHelper
+{
+""")
+    writeValuesSource(setting_helper_source, obj)
+    setting_helper_source.write("""} // namespace SettingsHelper
+""")
+    setting_helper_source.close()
+
     setting_info = open("generated/SettingsInfo.cpp",
                         mode="w", encoding="utf-8")
     setting_info.write(head)
@@ -20,12 +20,14 @@
  */
 
 #include "SignalHandler.hpp"
+#include "Core/EventLogger.hpp"
 #include <cassert>
 
 #ifndef _WIN32
 
 #include <QSocketNotifier>
 #include <csignal>
+#include <cstring>
 #include <sys/socket.h>
 #include <unistd.h>
 
@@ -42,6 +44,7 @@ SignalHandler *g_handler = nullptr;
 #ifdef _WIN32
 
 BOOL WINAPI WIN32_handleFunc(DWORD /*signal*/);
+LONG WINAPI WIN32_crashFunc(EXCEPTION_POINTERS * /*info*/);
 int WIN32_physicalToLogical(DWORD /*signal*/);
 DWORD WIN32_logicalToPhysical(int /*signal*/);
 std::set<int> g_registry;
@@ -49,7 +52,9 @@ std::set<int> g_registry;
 #else //_WIN32
 
 static int socketFd[32][2];
+static const int crashSignals[] = {SIGSEGV, SIGABRT, SIGFPE, SIGILL, SIGBUS};
 void POSIX_handleFunc(int signal);
+void POSIX_crashFunc(int signal);
 int POSIX_physicalToLogical(int signal);
 int POSIX_logicalToPhysical(int signal);
 
@@ -62,6 +67,16 @@ SignalHandler::SignalHandler(int mask) : _mask(mask)
 
 #ifdef _WIN32
     SetConsoleCtrlHandler(WIN32_handleFunc, TRUE);
+    SetUnhandledExceptionFilter(WIN32_crashFunc);
+#else
+    for (int signal : crashSignals)
+    {
+        struct sigaction sa;             // NOLINT
+        sa.sa_handler = POSIX_crashFunc; // NOLINT
+        sigemptyset(&sa.sa_mask);
+        sa.sa_flags = SA_RESETHAND; // the default action is taken when it's raised again in POSIX_crashFunc
+        ::sigaction(signal, &sa, nullptr);
+    }
 #endif //_WIN32
 
     for (int i = 0; i < numSignals; i++)
@@ -97,7 +112,10 @@ SignalHandler::~SignalHandler()
 {
 #ifdef _WIN32
     SetConsoleCtrlHandler(WIN32_handleFunc, FALSE);
+    SetUnhandledExceptionFilter(nullptr);
 #else
+    for (int signal : crashSignals)
+        ::signal(signal, SIG_DFL);
     for (int i = 0; i < numSignals; i++)
     {
         int logical = 0x1 << i;
@@ -193,6 +211,12 @@ BOOL WINAPI WIN32_handleFunc(DWORD signal)
     }
     return FALSE;
 }
+
+LONG WINAPI WIN32_crashFunc(EXCEPTION_POINTERS * /*info*/)
+{
+    Core::Log::dumpCrashReport("unhandled exception");
+    return EXCEPTION_CONTINUE_SEARCH;
+}
 #else
 void POSIX_handleFunc(int signal)
 {
@@ -203,6 +227,13 @@ void POSIX_handleFunc(int signal)
         ::write(socketFd[signo][0], &a, sizeof(a));
     }
 }
+
+void POSIX_crashFunc(int signal)
+{
+    // It's not async-signal-safe, but the application is crashing anyway, and the logs are worth the risk.
+    Core::Log::dumpCrashReport(strsignal(signal));
+    ::raise(signal);
+}
 #endif //_WIN32
 
 bool SignalHandler::handleSignal(int signal)
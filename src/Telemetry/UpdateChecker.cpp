@@ -17,6 +17,7 @@
 
 #include "Telemetry/UpdateChecker.hpp"
 #include "Core/EventLogger.hpp"
+#include "Core/StartupTracer.hpp"
 #include "Widgets/UpdatePresenter.hpp"
 #include "Widgets/UpdateProgressDialog.hpp"
 #include "generated/SettingsHelper.hpp"
@@ -36,6 +37,7 @@ namespace Telemetry
 {
 UpdateChecker::UpdateChecker()
 {
+    TRACE_STARTUP("UpdateChecker::UpdateChecker");
     progress = new Widgets::UpdateProgressDialog();
     presenter = new Widgets::UpdatePresenter();
     request = new QNetworkRequest(QUrl("https://api.github.com/repos/cpeditor/cpeditor/releases"));
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Util/DiffUtil.hpp"
+#include <QHash>
+
+namespace Util
+{
+const static int MAX_DIFF_DISTANCE = 2000; // the maximum number of inserted and removed lines for Myers' algorithm
+
+QVector<DiffHunk> lineDiff(const QStringList &oldLines, const QStringList &newLines)
+{
+    const int oldSize = oldLines.size();
+    const int newSize = newLines.size();
+
+    int prefix = 0;
+    while (prefix < oldSize && prefix < newSize && oldLines[prefix] == newLines[prefix])
+        ++prefix;
+    int suffix = 0;
+    while (suffix < oldSize - prefix && suffix < newSize - prefix &&
+           oldLines[oldSize - 1 - suffix] == newLines[newSize - 1 - suffix])
+        ++suffix;
+
+    // n and m are the sizes of the parts between the common prefix and the common suffix
+    const int n = oldSize - prefix - suffix;
+    const int m = newSize - prefix - suffix;
+    if (n == 0 && m == 0)
+        return {};
+    const DiffHunk whole{prefix, n, prefix, m};
+    if (n == 0 || m == 0)
+        return {whole};
+
+    // compare the hashes first, so that most unequal lines are not compared character by character
+    QVector<uint> oldHashes(n);
+    QVector<uint> newHashes(m);
+    for (int i = 0; i < n; ++i)
+        oldHashes[i] = qHash(oldLines[prefix + i]);
+    for (int i = 0; i < m; ++i)
+        newHashes[i] = qHash(newLines[prefix + i]);
+    const auto equal = [&](int x, int y) {
+        return oldHashes[x] == newHashes[y] && oldLines[prefix + x] == newLines[prefix + y];
+    };
+
+    // trace[d][k + d] is the furthest x on the diagonal k = x - y with d insertions and removals
+    QVector<QVector<int>> trace;
+    const int maxDistance = qMin(n + m, MAX_DIFF_DISTANCE);
+    bool found = false;
+    for (int d = 0; d <= maxDistance && !found; ++d)
+    {
+        QVector<int> v(2 * d + 1);
+        for (int k = -d; k <= d; k += 2)
+        {
+            int x = 0;
+            if (d > 0)
+            {
+                const auto &prev = trace[d - 1];
+                if (k == -d || (k != d && prev[k - 1 + d - 1] < prev[k + 1 + d - 1]))
+                    x = prev[k + 1 + d - 1]; // insert a line
+                else
+                    x = prev[k - 1 + d - 1] + 1; // remove a line
+            }
+            int y = x - k;
+            while (x < n && y < m && equal(x, y))
+            {
+                ++x;
+                ++y;
+            }
+            v[k + d] = x;
+            if (x >= n && y >= m)
+            {
+                found = true;
+                break;
+            }
+        }
+        trace.push_back(v);
+    }
+
+    if (!found)
+        return {whole};
+
+    QVector<bool> removed(n);
+    QVector<bool> inserted(m);
+    int x = n;
+    int y = m;
+    for (int d = trace.size() - 1; d > 0; --d)
+    {
+        const auto &prev = trace[d - 1];
+        const int k = x - y;
+        const bool insertion = k == -d || (k != d && prev[k - 1 + d - 1] < prev[k + 1 + d - 1]);
+        const int prevK = insertion ? k + 1 : k - 1;
+        const int prevX = prev[prevK + d - 1];
+        const int prevY = prevX - prevK;
+        while (x > prevX && y > prevY) // the unchanged lines after the insertion or the removal
+        {
+            --x;
+            --y;
+        }
+        if (insertion)
+            inserted[prevY] = true;
+        else
+            removed[prevX] = true;
+        x = prevX;
+        y = prevY;
+    }
+
+    QVector<DiffHunk> hunks;
+    int i = 0;
+    int j = 0;
+    while (i < n || j < m)
+    {
+        if ((i < n && removed[i]) || (j < m && inserted[j]))
+        {
+            DiffHunk hunk{prefix + i, 0, prefix + j, 0};
+            for (; i < n && removed[i]; ++i)
+                ++hunk.oldCount;
+            for (; j < m && inserted[j]; ++j)
+                ++hunk.newCount;
+            hunks.push_back(hunk);
+        }
+        else
+        {
+            ++i;
+            ++j;
+        }
+    }
+    return hunks;
+}
+} // namespace Util
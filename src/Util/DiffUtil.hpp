@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef DIFFUTIL_HPP
+#define DIFFUTIL_HPP
+
+#include <QStringList>
+#include <QVector>
+
+namespace Util
+{
+/**
+ * @brief the lines [oldStart, oldStart + oldCount) in the old text are replaced by [newStart, newStart + newCount)
+ */
+struct DiffHunk
+{
+    int oldStart;
+    int oldCount;
+    int newStart;
+    int newCount;
+};
+
+/**
+ * @brief get the differences between two texts by lines
+ * @returns the hunks in order, the lines between them are unchanged
+ * @note It uses Myers' algorithm, which is fast when there are few differences. If there are too many differences,
+ * everything between the common prefix and the common suffix is returned as a single hunk.
+ */
+QVector<DiffHunk> lineDiff(const QStringList &oldLines, const QStringList &newLines);
+
+} // namespace Util
+
+#endif // DIFFUTIL_HPP
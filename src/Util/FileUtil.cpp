@@ -17,18 +17,30 @@
 
 #include "Util/FileUtil.hpp"
 #include "Core/EventLogger.hpp"
+#include "Core/FileWatcher.hpp"
 #include "Core/MessageLogger.hpp"
 #include "generated/SettingsHelper.hpp"
 #include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QDesktopServices>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QMutex>
 #include <QProcess>
 #include <QSaveFile>
 #include <QStandardPaths>
 #include <QUrl>
 
+#ifdef Q_OS_WIN
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 namespace Util
 {
 QString fileNameFilter(bool cpp, bool java, bool python)
@@ -70,34 +82,122 @@ QString fileNameWithSuffix(const QString &name, const QString &lang)
     return result;
 }
 
+QString languageOfFile(const QString &path, const QString &fallback)
+{
+    const auto suffix = QFileInfo(path).suffix();
+    if (cppSuffix.contains(suffix))
+        return "C++";
+    if (javaSuffix.contains(suffix))
+        return "Java";
+    if (pythonSuffix.contains(suffix))
+        return "Python";
+    return fallback;
+}
+
+/*
+ * What saveFile() wrote last time, used to skip writing the same content again.
+ * The size and the modification time tell whether the file is modified by someone else after that.
+ */
+struct SavedFileState
+{
+    QByteArray hash;
+    qint64 size = -1;
+    QDateTime lastModified;
+};
+
+static QHash<QString, SavedFileState> savedFileStates; // by absolute file paths
+static QMutex savedFileStatesMutex;                     // guards savedFileStates
+const static int MAX_SAVED_FILE_STATES = 4096; // forget all states when there are too many, e.g. many temporary files
+
+static bool syncToDisk(QFile &file)
+{
+    if (!file.flush())
+        return false;
+#ifdef Q_OS_WIN
+    return FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(file.handle()))) != 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
 bool saveFile(const QString &path, const QString &content, const QString &head, bool safe, MessageLogger *log,
-              bool createDirectory)
+              bool createDirectory, FileKind kind)
 {
+    const auto data = content.toUtf8();
+    const auto hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    const auto absolutePath = QFileInfo(path).absoluteFilePath();
+
+    {
+        QMutexLocker locker(&savedFileStatesMutex);
+        auto it = savedFileStates.constFind(absolutePath);
+        if (it != savedFileStates.constEnd() && it->hash == hash)
+        {
+            const QFileInfo info(absolutePath);
+            if (info.exists() && info.size() == it->size && info.lastModified() == it->lastModified)
+            {
+                LOG_DEBUG("Skipped saving [" << path << "], the content is unchanged");
+                return true;
+            }
+        }
+    }
+
     if (createDirectory)
     {
         auto dirPath = QFileInfo(path).absolutePath();
         LOG_ERR_IF(!QDir().mkpath(dirPath), QString("Failed to create the directory [%1]").arg(dirPath));
     }
-    if (safe && !SettingsHelper::isSaveFaster())
+
+    bool atomic = false; // write to a temporary file, sync it and rename it
+    bool sync = false;   // sync the file in place
+    switch (kind)
+    {
+    case FileKind::Source:
+        atomic = safe && !SettingsHelper::isSaveFaster();
+        sync = safe && SettingsHelper::isSaveFaster();
+        break;
+    case FileKind::TestCase:
+        sync = safe;
+        break;
+    case FileKind::Session:
+        atomic = true;
+        break;
+    case FileKind::Temp:
+        break;
+    }
+
+    const auto openFailed = [&] {
+        if (log != nullptr)
+            log->error(head, QCoreApplication::translate("Util::FileUtil",
+                                                         "Failed to open [%1]. Do I have write permission?")
+                                 .arg(path));
+        LOG_ERR("Failed to open [" << path << "]");
+    };
+    const auto saveFailed = [&] {
+        if (log != nullptr)
+            log->error(head, QCoreApplication::translate("Util::FileUtil",
+                                                         "Failed to save to [%1]. Do I have write permission?")
+                                 .arg(path));
+        LOG_ERR("Failed to save to [" << path << "]");
+    };
+
+    {
+        // the file may be partially written if it fails, so it's not the saved content any more
+        QMutexLocker locker(&savedFileStatesMutex);
+        savedFileStates.remove(absolutePath);
+    }
+
+    if (atomic)
     {
         QSaveFile file(path);
         if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
         {
-            if (log != nullptr)
-                log->error(head, QCoreApplication::translate("Util::FileUtil",
-                                                             "Failed to open [%1]. Do I have write permission?")
-                                     .arg(path));
-            LOG_ERR("Failed to open [" << path << "]");
+            openFailed();
             return false;
         }
-        file.write(content.toUtf8());
-        if (!file.commit())
+        file.write(data);
+        if (!file.commit()) // QSaveFile syncs the file before renaming it
         {
-            if (log != nullptr)
-                log->error(head, QCoreApplication::translate("Util::FileUtil",
-                                                             "Failed to save to [%1]. Do I have write permission?")
-                                     .arg(path));
-            LOG_ERR("Failed to save to [" << path << "]");
+            saveFailed();
             return false;
         }
     }
@@ -106,23 +206,30 @@ bool saveFile(const QString &path, const QString &content, const QString &head,
         QFile file(path);
         if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
         {
-            if (log != nullptr)
-                log->error(head, QCoreApplication::translate("Util::FileUtil",
-                                                             "Failed to open [%1]. Do I have write permission?")
-                                     .arg(path));
-            LOG_ERR("unsafe: Failed to open [" << path << "]");
+            openFailed();
             return false;
         }
-        if (file.write(content.toUtf8()) == -1)
+        if (file.write(data) == -1)
         {
-            if (log != nullptr)
-                log->error(head, QCoreApplication::translate("Util::FileUtil",
-                                                             "Failed to save to [%1]. Do I have write permission?")
-                                     .arg(path));
-            LOG_ERR("unsafe: Failed to save to [" << path << "]");
+            saveFailed();
             return false;
         }
+        if (sync && !syncToDisk(file))
+            LOG_WARN("Failed to sync [" << path << "] to the disk");
+    }
+
+    const QFileInfo info(absolutePath);
+    {
+        QMutexLocker locker(&savedFileStatesMutex);
+        if (savedFileStates.size() >= MAX_SAVED_FILE_STATES)
+            savedFileStates.clear();
+        savedFileStates[absolutePath] = {hash, info.size(), info.lastModified()};
     }
+
+    // the files in the tabs are watched, and our own writes are not external changes
+    if (kind == FileKind::Source || kind == FileKind::TestCase)
+        Core::FileWatcher::instance()->setWrittenContent(absolutePath, hash);
+
     LOG_INFO("Successfully saved to [" << path << "]");
     return true;
 }
@@ -156,6 +263,26 @@ QString readFile(const QString &path, const QString &head, MessageLogger *log, b
     return content;
 }
 
+bool isPlainFileName(const QString &name)
+{
+    return !name.isEmpty() && !QDir::isAbsolutePath(name) && !name.contains('/') && !name.contains('\\') &&
+           !name.contains(':') && !name.contains("..");
+}
+
+bool linkOrCopyFile(const QString &source, const QString &target)
+{
+#ifdef Q_OS_WIN
+    if (CreateHardLinkW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(target).utf16()),
+                        reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(source).utf16()), nullptr))
+        return true;
+#else
+    if (::link(QFile::encodeName(source).constData(), QFile::encodeName(target).constData()) == 0)
+        return true;
+#endif
+    LOG_INFO("Failed to link " << source << " to " << target << ", copying it instead");
+    return QFile::copy(source, target);
+}
+
 QString configFilePath(QString path)
 {
     QDir configDir(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation));
@@ -35,10 +35,41 @@ const static QString exeSuffix = "";
 
 QString fileNameWithSuffix(const QString &name, const QString &lang);
 
+/**
+ * @brief get the language of a source file by its suffix
+ * @param path the path to the source file
+ * @param fallback the language returned if the suffix is unknown
+ * @returns one of "C++", "Java" and "Python", or *fallback*
+ */
+QString languageOfFile(const QString &path, const QString &fallback);
+
 QString fileNameFilter(bool cpp, bool java, bool python);
 
+/**
+ * The kinds of files written by saveFile(). They decide how hard it tries to keep the file on the disk.
+ */
+enum class FileKind
+{
+    Source,   // safe: written to a temporary file, synced and renamed; "Save Faster": synced in place
+    TestCase, // safe: synced in place, so that saving many test cases doesn't rename many files
+    Session,  // always written to a temporary file, synced and renamed
+    Temp,     // written in place and never synced, they are re-generated when needed
+};
+
+/**
+ * @brief save the content to a file
+ * @param path the path to the file
+ * @param content the content of the file, encoded in UTF-8
+ * @param head the head of the log
+ * @param safe whether to make sure the file is on the disk, it's false for auto-save
+ * @param log the MessageLogger to display the messages
+ * @param createDirectory whether to create the parent directory if it doesn't exist
+ * @param kind decides how the file is written together with *safe*
+ * @returns whether the file is saved
+ * @note If the same content was saved to the same path, and the file is not modified after that, nothing is written.
+ */
 bool saveFile(const QString &path, const QString &content, const QString &head = "Save File", bool safe = true,
-              MessageLogger *log = nullptr, bool createDirectory = false);
+              MessageLogger *log = nullptr, bool createDirectory = false, FileKind kind = FileKind::Source);
 
 /**
  * @brief get the content of a file
@@ -53,6 +84,23 @@ bool saveFile(const QString &path, const QString &content, const QString &head =
 QString readFile(const QString &path, const QString &head = "Read File", MessageLogger *log = nullptr,
                  bool notExistWarning = false);
 
+/**
+ * @brief check whether a name refers to a file directly in the directory it's used in
+ * @returns false if the name is empty or absolute, or contains a path separator, a colon or ".."
+ * @note This is for the names from untrusted sources, so that they can't point to a file outside the directory.
+ */
+bool isPlainFileName(const QString &name);
+
+/**
+ * @brief make a file available at another path without copying its content if possible
+ * @param source the path to the existing file
+ * @param target the path to the new file, which should not exist
+ * @returns whether the file is linked or copied
+ * @note It tries a hard link first, and falls back to a copy, e.g. when the paths are on different file systems.
+ *       The two paths share the content when linked, so this is for files that are not written afterwards.
+ */
+bool linkOrCopyFile(const QString &source, const QString &target);
+
 /**
  * @brief get the path of a configuration file
  * @param path the original path
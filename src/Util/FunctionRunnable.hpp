@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef FUNCTIONRUNNABLE_HPP
+#define FUNCTIONRUNNABLE_HPP
+
+#include <QRunnable>
+#include <functional>
+
+namespace Util
+{
+
+/**
+ * @brief a QRunnable which calls a function, used to run a function in a QThreadPool
+ * @note QRunnable::create() can be used instead after requiring Qt 5.15
+ */
+class FunctionRunnable : public QRunnable
+{
+  public:
+    explicit FunctionRunnable(std::function<void()> function) : function(std::move(function))
+    {
+    }
+
+    void run() override
+    {
+        function();
+    }
+
+  private:
+    std::function<void()> function;
+};
+
+} // namespace Util
+
+#endif // FUNCTIONRUNNABLE_HPP
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Widgets/TabPlaceholder.hpp"
+#include <QDateTime>
+
+namespace Widgets
+{
+TabPlaceholder::TabPlaceholder(const MainWindow::EditorStatus &status, QWidget *parent)
+    : QWidget(parent), status(status), filePending(status.filePending)
+{
+}
+
+TabPlaceholder::TabPlaceholder(const QVariantMap &sessionStatus, const QString &blobDirectory, QWidget *parent)
+    : QWidget(parent), status(sessionStatus), sessionStatus(sessionStatus), blobDirectory(blobDirectory),
+      filePending(status.filePending)
+{
+}
+
+TabPlaceholder::TabPlaceholder(const MainWindow::EditorStatus &status, const Extensions::CompanionData &companion,
+                               QWidget *parent)
+    : QWidget(parent), status(status), companionPending(true), companion(companion)
+{
+}
+
+TabPlaceholder::TabPlaceholder(const QString &filePath, const QString &language, int untitledIndex, QWidget *parent)
+    : QWidget(parent), filePending(true)
+{
+    status.timestamp = QDateTime::currentMSecsSinceEpoch();
+    status.filePending = true;
+    status.filePath = filePath;
+    status.untitledIndex = untitledIndex;
+    status.isLanguageSet = true;
+    status.language = language;
+}
+
+MainWindow::EditorStatus TabPlaceholder::getStatus() const
+{
+    return status;
+}
+
+bool TabPlaceholder::hasSessionStatus() const
+{
+    return !sessionStatus.isEmpty();
+}
+
+QVariantMap TabPlaceholder::getSessionStatus() const
+{
+    return sessionStatus;
+}
+
+QString TabPlaceholder::getBlobDirectory() const
+{
+    return blobDirectory;
+}
+
+QString TabPlaceholder::getFilePath() const
+{
+    return status.filePath;
+}
+
+QString TabPlaceholder::getProblemURL() const
+{
+    return status.problemURL;
+}
+
+int TabPlaceholder::getUntitledIndex() const
+{
+    return status.untitledIndex;
+}
+
+bool TabPlaceholder::isUntitled() const
+{
+    return status.filePath.isEmpty();
+}
+
+QString TabPlaceholder::getCompleteTitle() const
+{
+    return MainWindow::getCompleteTitle(status.filePath, status.problemURL, status.untitledIndex);
+}
+
+QString TabPlaceholder::getTabTitle(bool complete, bool star, int removeLength) const
+{
+    return MainWindow::getTabTitle(status.filePath, status.problemURL, status.untitledIndex, complete,
+                                   star && isTextChanged(), removeLength);
+}
+
+bool TabPlaceholder::isTextChanged() const
+{
+    // the texts in blobs are empty in the status, and the blobs are named by the hashes of the texts
+    return status.editorText != status.savedText ||
+           sessionStatus.value("editorTextBlob") != sessionStatus.value("savedTextBlob");
+}
+
+bool TabPlaceholder::hasCompanionData() const
+{
+    return companionPending;
+}
+
+Extensions::CompanionData TabPlaceholder::getCompanionData() const
+{
+    return companion;
+}
+
+bool TabPlaceholder::hasPendingFile() const
+{
+    return filePending;
+}
+} // namespace Widgets
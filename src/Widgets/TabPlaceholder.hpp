@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2019-2021 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CP Editor.
+ *
+ * CP Editor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CP Editor behaves in unexpected way and
+ * causes your ratings to go down and or lose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+/*
+ * A TabPlaceholder takes the place of a MainWindow in the tab widget until the tab is activated.
+ * It only keeps the status of the tab, so restoring a session doesn't construct the editors, the test cases,
+ * the file watchers and so on for the tabs that are not shown.
+ * AppWindow::windowAt() replaces it by a MainWindow restored from the status when the tab is needed.
+ * A placeholder can also hold a problem imported from Competitive Companion, then the MainWindow opens the file (or a
+ * new untitled tab) and applies the problem when it's loaded, and the status is only used to save the session.
+ * A placeholder can also hold a file found when opening a folder, then the file is only read when the tab is loaded.
+ * The session keeps such a tab as a pending file without its text, so it's still a placeholder after restoring.
+ * A placeholder restored from the session keeps the hashes of the blobs of its texts instead of the texts, the blobs
+ * are only read when the tab is loaded.
+ */
+
+#ifndef TABPLACEHOLDER_HPP
+#define TABPLACEHOLDER_HPP
+
+#include "Extensions/CompanionServer.hpp"
+#include "mainwindow.hpp"
+#include <QVariantMap>
+#include <QWidget>
+
+namespace Widgets
+{
+class TabPlaceholder : public QWidget
+{
+    Q_OBJECT
+
+  public:
+    explicit TabPlaceholder(const MainWindow::EditorStatus &status, QWidget *parent = nullptr);
+
+    /**
+     * @brief a placeholder restored from the session
+     * @param sessionStatus the status in the session, where the texts may be replaced by the hashes of their blobs
+     * @param blobDirectory the directory of the blobs of the session
+     */
+    explicit TabPlaceholder(const QVariantMap &sessionStatus, const QString &blobDirectory, QWidget *parent = nullptr);
+
+    /**
+     * @brief a placeholder of a problem imported from Competitive Companion
+     * @param status the status used to save the session before the tab is loaded
+     * @param companion the problem applied when the tab is loaded
+     */
+    explicit TabPlaceholder(const MainWindow::EditorStatus &status, const Extensions::CompanionData &companion,
+                            QWidget *parent = nullptr);
+
+    /**
+     * @brief a placeholder of a file which is opened when the tab is loaded
+     * @param filePath the path to the file
+     * @param language the language of the file
+     * @param untitledIndex the untitled index of the tab
+     */
+    explicit TabPlaceholder(const QString &filePath, const QString &language, int untitledIndex,
+                            QWidget *parent = nullptr);
+
+    /**
+     * @brief the status to restore the MainWindow from
+     * @note For a placeholder of a file, the texts are empty and filePending is set, the file is not read here.
+     * For a placeholder restored from the session, the texts in blobs are empty, use getSessionStatus() instead.
+     */
+    MainWindow::EditorStatus getStatus() const;
+
+    /**
+     * @brief whether it's restored from the session, then its texts may be in blobs which are not read yet
+     */
+    bool hasSessionStatus() const;
+
+    /**
+     * @brief the status in the session, where the texts may be replaced by the hashes of their blobs
+     */
+    QVariantMap getSessionStatus() const;
+
+    /**
+     * @brief the directory of the blobs of the session status
+     */
+    QString getBlobDirectory() const;
+
+    QString getFilePath() const;
+    QString getProblemURL() const;
+    int getUntitledIndex() const;
+    bool isUntitled() const;
+    QString getCompleteTitle() const;
+    QString getTabTitle(bool complete, bool star, int removeLength = 0) const;
+
+    /**
+     * @brief whether the text is changed in the status
+     * @note It compares the editor text with the saved text in the status, without reading the file or the blobs.
+     */
+    bool isTextChanged() const;
+
+    /**
+     * @brief whether it's a problem imported from Competitive Companion, which is applied when the tab is loaded
+     */
+    bool hasCompanionData() const;
+    Extensions::CompanionData getCompanionData() const;
+
+    /**
+     * @brief whether it's a placeholder of a file, which is opened when the tab is loaded
+     * @note This is kept when the placeholder is saved in the session and restored.
+     */
+    bool hasPendingFile() const;
+
+  private:
+    MainWindow::EditorStatus status;
+    QVariantMap sessionStatus; // the status in the session, empty if it's not restored from the session
+    QString blobDirectory;     // the directory of the blobs of sessionStatus
+    bool companionPending = false;
+    bool filePending = false;
+    Extensions::CompanionData companion;
+};
+} // namespace Widgets
+
+#endif // TABPLACEHOLDER_HPP
@@ -100,6 +100,11 @@ TestCase::TestCase(int index, MessageLogger *logger, QWidget *parent, const QStr
     connect(diffViewer, &DiffViewer::toLongForHtml, this, &TestCase::onToLongForHtml);
     connect(expectedEdit, &TestCaseEdit::requestCopyOutputToExpected, this,
             [this] { expectedEdit->modifyText(output()); });
+
+    connect(inputEdit, &TestCaseEdit::textChanged, this, &TestCase::statusChanged);
+    connect(expectedEdit, &TestCaseEdit::textChanged, this, &TestCase::statusChanged);
+    connect(checkBox, &QCheckBox::toggled, this, &TestCase::statusChanged);
+    connect(splitter, &QSplitter::splitterMoved, this, &TestCase::statusChanged);
 }
 
 void TestCase::setInput(const QString &text)
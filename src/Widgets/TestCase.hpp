@@ -71,6 +71,7 @@ class TestCase : public QWidget
   signals:
     void deleted(TestCase *widget);
     void requestRun(int index);
+    void statusChanged(); // the input, the expected output, the checked state or the splitter sizes is changed
 
   private slots:
     void onCheckBoxToggled(bool checked);
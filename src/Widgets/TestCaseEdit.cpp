@@ -165,7 +165,8 @@ void TestCaseEdit::onCustomContextMenuRequested(const QPoint &pos)
         QString fileName =
             DefaultPathManager::getSaveFileName("Save Test Case To A File", this, tr("Save test case to file"));
         if (!fileName.isEmpty())
-            Util::saveFile(fileName, getText(), tr("Save test case to file"), true, log);
+            Util::saveFile(fileName, getText(), tr("Save test case to file"), true, log, false,
+                           Util::FileKind::TestCase);
     });
 
     if (role != Output)
@@ -17,6 +17,7 @@
 
 #include "Widgets/TestCases.hpp"
 #include "Core/EventLogger.hpp"
+#include "Core/FileWatcher.hpp"
 #include "Core/MessageLogger.hpp"
 #include "Core/TestCasesCopyPaster.hpp"
 #include "Settings/DefaultPathManager.hpp"
@@ -24,8 +25,10 @@
 #include "Widgets/TestCase.hpp"
 #include "generated/SettingsHelper.hpp"
 #include <QComboBox>
+#include <QDir>
 #include <QFileInfo>
 #include <QHBoxLayout>
+#include <QHash>
 #include <QLabel>
 #include <QMenu>
 #include <QMessageBox>
@@ -261,6 +264,7 @@ TestCases::TestCases(MessageLogger *logger, QWidget *parent) : QWidget(parent),
     checkerComboBox->setCurrentIndex(0);
 
     connect(checkerComboBox, qOverload<int>(&QComboBox::currentIndexChanged), this, &TestCases::checkerChanged);
+    connect(this, &TestCases::checkerChanged, this, &TestCases::statusChanged);
     connect(addButton, &QPushButton::clicked, this, &TestCases::on_addButton_clicked);
     connect(addCheckerButton, &QPushButton::clicked, this, &TestCases::on_addCheckerButton_clicked);
 }
@@ -297,9 +301,11 @@ void TestCases::addTestCase(const QString &input, const QString &expected)
         auto *testcase = new TestCase(count(), log, this, input, expected);
         connect(testcase, &TestCase::deleted, this, &TestCases::onChildDeleted);
         connect(testcase, &TestCase::requestRun, this, &TestCases::requestRun);
+        connect(testcase, &TestCase::statusChanged, this, &TestCases::statusChanged);
         testcases.push_back(testcase);
         scrollAreaLayout->addWidget(testcase);
         updateVerdicts();
+        emit statusChanged();
     }
 }
 
@@ -377,15 +383,104 @@ void TestCases::loadFromSavedFiles(const QString &filePath)
         addTestCase();
 }
 
+void TestCases::setWatchedFilePath(const QString &filePath)
+{
+    QStringList files;
+    if (!filePath.isEmpty())
+    {
+        for (int i = 0; i < MAX_NUMBER_OF_TESTCASES; ++i)
+            files << inputFilePath(filePath, i) << answerFilePath(filePath, i);
+    }
+    if (files == testCaseFiles)
+        return;
+
+    Core::FileWatcher::instance()->unwatch(this);
+    testCaseFiles = files;
+    watchedFiles.clear();
+    watchedDirectories.clear();
+    watchExistingFiles(false);
+}
+
+void TestCases::watchExistingFiles(bool reportNewFiles)
+{
+    // Watching all the possible test case files would take a watch for each of them, which quickly exhausts the
+    // limit of inotify with many tabs, so only the existing files are watched, and a file created later is noticed
+    // by the watch on its directory.
+    auto *watcher = Core::FileWatcher::instance();
+    QHash<QString, QSet<QString>> fileNames; // the names of the files in each directory
+    for (int i = 0; i < testCaseFiles.length(); ++i)
+    {
+        const QFileInfo info(testCaseFiles[i]);
+        const auto directory = info.absolutePath();
+        auto it = fileNames.find(directory);
+        if (it == fileNames.end())
+        {
+            const auto names = QDir(directory).entryList(QDir::Files | QDir::Hidden);
+            it = fileNames.insert(directory, QSet<QString>(names.begin(), names.end()));
+            if (!watchedDirectories.contains(directory) && QFileInfo(directory).isDir())
+            {
+                watchedDirectories.insert(directory);
+                watcher->watchDirectory(this, directory,
+                                        [this](const QString & /*path*/) { watchExistingFiles(true); });
+            }
+        }
+        if (watchedFiles.contains(testCaseFiles[i]) || !it->contains(info.fileName()))
+            continue;
+
+        watchedFiles.insert(testCaseFiles[i]);
+        watcher->watch(this, testCaseFiles[i], [this, i](const QString & /*path*/, const QString &content) {
+            onSavedFileChanged(i / 2, i % 2 == 1, content);
+        });
+        if (reportNewFiles)
+            onSavedFileChanged(i / 2, i % 2 == 1, Util::readFile(testCaseFiles[i]));
+    }
+}
+
+void TestCases::onSavedFileChanged(int index, bool isAnswer, const QString &content)
+{
+    // removed files are ignored, the test cases are removed only in the application
+    if (content.isNull() || index >= MAX_NUMBER_OF_TESTCASES)
+        return;
+    if (index < count() && (isAnswer ? expected(index) : input(index)) == content)
+        return;
+
+    LOG_INFO("Loading the changed test case file " << INFO_OF(index) << INFO_OF(isAnswer));
+    while (count() <= index)
+        addTestCase();
+    if (isAnswer)
+        setExpected(index, content);
+    else
+        setInput(index, content);
+}
+
+QVector<QPair<QString, QString>> TestCases::readSavedFiles(const QString &filePath)
+{
+    QVector<QPair<QString, QString>> res;
+    for (int i = MAX_NUMBER_OF_TESTCASES - 1; i >= 0; --i)
+    {
+        if (QFile::exists(inputFilePath(filePath, i)) || QFile::exists(answerFilePath(filePath, i)))
+        {
+            for (int j = 0; j <= i; ++j)
+            {
+                res.push_back(
+                    {Util::readFile(inputFilePath(filePath, j)), Util::readFile(answerFilePath(filePath, j))});
+            }
+            break;
+        }
+    }
+    return res;
+}
+
 void TestCases::saveToFiles(const QString &filePath, bool safe)
 {
     for (int i = 0; i < count(); ++i)
     {
         if (!input(i).isEmpty())
-            Util::saveFile(inputFilePath(filePath, i), input(i), tr("Save Input #%1").arg(i + 1), safe, log, true);
+            Util::saveFile(inputFilePath(filePath, i), input(i), tr("Save Input #%1").arg(i + 1), safe, log, true,
+                           Util::FileKind::TestCase);
         if (!expected(i).isEmpty())
             Util::saveFile(answerFilePath(filePath, i), expected(i), tr("Save Expected #%1").arg(i + 1), safe, log,
-                           true);
+                           true, Util::FileKind::TestCase);
     }
     for (int i = count(); i < MAX_NUMBER_OF_TESTCASES; ++i)
     {
@@ -396,6 +491,9 @@ void TestCases::saveToFiles(const QString &filePath, bool safe)
         if (QFile::exists(answerPath))
             QFile::remove(answerPath);
     }
+
+    // the directories of the test case files may be created just now
+    watchExistingFiles(false);
 }
 
 QString TestCases::loadTestCaseFromFile(const QString &path, const QString &head)
@@ -465,6 +563,7 @@ int TestCases::checkerIndex() const
 void TestCases::addCustomCheckers(const QStringList &list)
 {
     checkerComboBox->addItems(list);
+    emit statusChanged();
 }
 
 QStringList TestCases::customCheckers() const
@@ -553,6 +652,7 @@ void TestCases::onChildDeleted(TestCase *widget)
     for (int i = 0; i < count(); ++i)
         testcases[i]->setID(i);
     updateVerdicts();
+    emit statusChanged();
 }
 
 bool TestCases::validateIndex(int index, const QString &funcName) const
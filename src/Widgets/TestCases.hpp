@@ -19,6 +19,7 @@
 #define TESTCASES_HPP
 
 #include "Core/Checker.hpp"
+#include <QSet>
 #include <QWidget>
 
 class MessageLogger;
@@ -75,6 +76,18 @@ class TestCases : public QWidget
     void loadFromSavedFiles(const QString &filePath);
     void saveToFiles(const QString &filePath, bool safe);
 
+    /**
+     * @brief read the saved test case files of a source file without loading them into the widget
+     * @returns the pairs of the input and the expected output, empty if there are no saved files
+     */
+    static QVector<QPair<QString, QString>> readSavedFiles(const QString &filePath);
+
+    /**
+     * @brief watch the saved test case files of a source file, and load them when they are changed on the disk
+     * @param filePath the path to the source file, or an empty string to stop watching
+     */
+    void setWatchedFilePath(const QString &filePath);
+
     QString loadTestCaseFromFile(const QString &path, const QString &head);
 
     void setTestCaseEditFont(const QFont &font);
@@ -90,15 +103,24 @@ class TestCases : public QWidget
   signals:
     void checkerChanged();
     void requestRun(int index);
+    void statusChanged(); // anything saved in the session is changed
 
   private slots:
     void on_addButton_clicked();
     void on_addCheckerButton_clicked();
     void onChildDeleted(TestCase *widget);
+    void onSavedFileChanged(int index, bool isAnswer, const QString &content);
 
   private:
     bool validateIndex(int index, const QString &funcName) const;
     void updateVerdicts();
+
+    /**
+     * @brief watch the test case files that exist now, and the directories where the others may be created
+     * @param reportNewFiles whether to load the files that are not watched before
+     */
+    void watchExistingFiles(bool reportNewFiles);
+
     static QString inputFilePath(const QString &filePath, int index);
     static QString answerFilePath(const QString &filePath, int index);
     static QString testCaseFilePath(QString rule, const QString &filePath, int index);
@@ -115,6 +137,9 @@ class TestCases : public QWidget
     QList<TestCase *> testcases;
     MessageLogger *log;
     bool choosingChecker = false;
+    QStringList testCaseFiles;        // the paths of all test case files of the watched source file
+    QSet<QString> watchedFiles;       // the existing test case files watched by Core::FileWatcher
+    QSet<QString> watchedDirectories; // the directories of the test case files watched by Core::FileWatcher
 };
 } // namespace Widgets
 #endif // TESTCASES_HPP
@@ -19,8 +19,10 @@
 #include "../ui/ui_appwindow.h"
 #include "Core/Compiler.hpp"
 #include "Core/EventLogger.hpp"
+#include "Core/FolderScanner.hpp"
 #include "Core/MessageLogger.hpp"
 #include "Core/SessionManager.hpp"
+#include "Core/StartupTracer.hpp"
 #include "Core/StyleManager.hpp"
 #include "Core/Translator.hpp"
 #include "Extensions/CFTool.hpp"
@@ -30,15 +32,18 @@
 #include "Settings/DefaultPathManager.hpp"
 #include "Settings/FileProblemBinder.hpp"
 #include "Settings/PreferencesWindow.hpp"
+#include "Settings/SettingsManager.hpp"
 #include "Telemetry/UpdateChecker.hpp"
 #include "Util/FileUtil.hpp"
 #include "Util/Util.hpp"
 #include "Widgets/SupportUsDialog.hpp"
+#include "Widgets/TabPlaceholder.hpp"
 #include "application.hpp"
 #include "generated/SettingsHelper.hpp"
 #include "generated/portable.hpp"
 #include "generated/version.hpp"
 #include <QClipboard>
+#include <QDateTime>
 #include <QDesktopServices>
 #include <QDragEnterEvent>
 #include <QFontDatabase>
@@ -48,6 +53,7 @@
 #include <QMimeData>
 #include <QProgressDialog>
 #include <QShortcut>
+#include <QSignalBlocker>
 #include <QSplitter>
 #include <QTabBar>
 #include <QTimer>
@@ -56,6 +62,7 @@
 
 AppWindow::AppWindow(bool noRestoreSession, QWidget *parent) : QMainWindow(parent), ui(new Ui::AppWindow)
 {
+    TRACE_STARTUP("AppWindow::AppWindow");
     LOG_INFO(BOOL_INFO_OF(noRestoreSession))
     ui->setupUi(this);
     setAcceptDrops(true);
@@ -110,9 +117,6 @@ AppWindow::AppWindow(bool noRestoreSession, QWidget *parent) : QMainWindow(paren
     applySettings();
     onSettingsApplied("");
 
-    if (SettingsHelper::isCheckUpdate())
-        updateChecker->checkUpdate(true);
-
     if (noRestoreSession || (!SettingsHelper::isForceClose() && !SettingsHelper::isHotExitEnable()))
         return;
 
@@ -162,6 +166,7 @@ AppWindow::AppWindow(bool cpp, bool java, bool python, bool noRestoreSession, in
 
 void AppWindow::finishConstruction()
 {
+    TRACE_STARTUP("AppWindow::finishConstruction");
     if (ui->tabWidget->count() == 0)
         openTab("");
 
@@ -171,6 +176,9 @@ void AppWindow::finishConstruction()
         setWindowOpacity(1);
 #endif
 
+    // in case the window is never painted, e.g. it's minimized by the window manager
+    QTimer::singleShot(DEFERRED_SERVICES_TIMEOUT, this, &AppWindow::startDeferredServices);
+
     QTimer::singleShot(200, [this] {
         // The window needs time to make its geometry stable. We wait it to display the new dialogs in correct positions
         if (SettingsHelper::isFirstTimeUser())
@@ -266,6 +274,16 @@ void AppWindow::changeEvent(QEvent *event)
     QMainWindow::changeEvent(event);
 }
 
+void AppWindow::paintEvent(QPaintEvent *event)
+{
+    QMainWindow::paintEvent(event);
+    if (!deferredServicesStarted)
+    {
+        // start them after the first frame is shown, so that they don't delay it
+        QTimer::singleShot(0, this, &AppWindow::startDeferredServices);
+    }
+}
+
 /******************** PRIVATE METHODS ********************/
 void AppWindow::setConnections()
 {
@@ -277,10 +295,11 @@ void AppWindow::setConnections()
     connect(lspTimerCpp, &QTimer::timeout, this, &AppWindow::onLSPTimerElapsedCpp);
     connect(lspTimerJava, &QTimer::timeout, this, &AppWindow::onLSPTimerElapsedJava);
     connect(lspTimerPython, &QTimer::timeout, this, &AppWindow::onLSPTimerElapsedPython);
+    connect(companionTimer, &QTimer::timeout, this, &AppWindow::processCompanionQueue);
 
     connect(preferencesWindow, &PreferencesWindow::settingsApplied, this, &AppWindow::onSettingsApplied);
-
-    connect(server, &Extensions::CompanionServer::onRequestArrived, this, &AppWindow::onIncomingCompanionRequest);
+    SettingsManager::subscribe(this, {SettingsHelper::Key::UIStyle},
+                               [] { Core::StyleManager::setStyle(SettingsHelper::getUIStyle()); });
 
     connect(trayIcon, &QSystemTrayIcon::activated, this, &AppWindow::onTrayIconActivated);
     connect(trayIcon, &QSystemTrayIcon::messageClicked, this, &AppWindow::showOnTop);
@@ -291,18 +310,13 @@ void AppWindow::setConnections()
 
 void AppWindow::allocate()
 {
+    TRACE_STARTUP("AppWindow::allocate");
     lspTimerCpp = new QTimer();
     lspTimerJava = new QTimer();
     lspTimerPython = new QTimer();
     updateChecker = new Telemetry::UpdateChecker();
     preferencesWindow = new PreferencesWindow(this);
 
-    server = new Extensions::CompanionServer(SettingsHelper::getCompetitiveCompanionConnectionPort());
-
-    cppServer = new Extensions::LanguageServer("C++");
-    javaServer = new Extensions::LanguageServer("Java");
-    pythonServer = new Extensions::LanguageServer("Python");
-
     findReplaceDialog = new FindReplaceDialog(this);
     findReplaceDialog->setModal(false);
     findReplaceDialog->setWindowFlags(Qt::Dialog | Qt::WindowMinimizeButtonHint | Qt::WindowMaximizeButtonHint |
@@ -323,11 +337,16 @@ void AppWindow::allocate()
 
     sessionManager = new Core::SessionManager(this);
 
+    companionTimer = new QTimer(this);
+    companionTimer->setSingleShot(true);
+    companionTimer->setInterval(COMPANION_BATCH_INTERVAL);
+
     wakaTime = new Extensions::WakaTime(this);
 }
 
 void AppWindow::applySettings()
 {
+    TRACE_STARTUP("AppWindow::applySettings");
     LOG_INFO("Applying settings to Application from Settings");
     QString mode = SettingsHelper::getViewMode();
 
@@ -400,6 +419,14 @@ void AppWindow::maybeSetHotkeys()
 bool AppWindow::closeTab(int index)
 {
     LOG_INFO(INFO_OF(index));
+    auto *placeholder = placeholderAt(index);
+    if (placeholder != nullptr && !placeholder->isTextChanged())
+    {
+        ui->tabWidget->removeTab(index);
+        onEditorFileChanged();
+        delete placeholder;
+        return true;
+    }
     auto *tmp = windowAt(index);
     if (tmp->closeConfirm())
     {
@@ -419,9 +446,10 @@ void AppWindow::saveSettings()
     // findReplaceDialog->writeSettings(*SettingsHelper::settings()); FIX IT!!!
 }
 
-void AppWindow::openTab(MainWindow *window, MainWindow *after)
+void AppWindow::connectWindow(MainWindow *window)
 {
     connect(window, &MainWindow::confirmTriggered, this, &AppWindow::onConfirmTriggered);
+    connect(window, &MainWindow::editorFileChanged, this, [this, window] { updateTabIndex(window); });
     connect(window, &MainWindow::editorFileChanged, this, &AppWindow::onEditorFileChanged);
     connect(window, &MainWindow::requestUpdateLanguageServerFilePath, this, &AppWindow::updateLanguageServerFilePath);
     connect(window, &MainWindow::editorLanguageChanged, this, &AppWindow::onEditorLanguageChanged);
@@ -430,10 +458,17 @@ void AppWindow::openTab(MainWindow *window, MainWindow *after)
             [this](QString const &head, QString const &body) { trayIcon->showMessage(head, body); });
     connect(window, &MainWindow::compileOrRunTriggered, this, &AppWindow::onCompileOrRunTriggered);
     connect(window, &MainWindow::fileSaved, this, &AppWindow::onFileSaved);
+    sessionManager->trackTab(window);
+}
+
+void AppWindow::openTab(MainWindow *window, MainWindow *after)
+{
+    connectWindow(window);
 
     ui->tabWidget->setCurrentIndex(
         ui->tabWidget->insertTab(after ? ui->tabWidget->indexOf(after) + 1 : ui->tabWidget->currentIndex() + 1, window,
                                  window->getTabTitle(false, true)));
+    updateTabIndex(window);
 
     window->getEditor()->setFocus();
     onEditorFileChanged();
@@ -458,6 +493,7 @@ void AppWindow::openTabs(const QStringList &paths)
 
     auto oldSize = size();
     setUpdatesEnabled(false);
+    isOpeningTabs = true;
 
     for (int i = 0; i < length; ++i)
     {
@@ -468,6 +504,8 @@ void AppWindow::openTabs(const QStringList &paths)
         progress.setLabelText(currentWindow()->getTabTitle(true, false));
     }
 
+    isOpeningTabs = false;
+    onEditorFileChanged(); // the titles of all tabs are updated once instead of once per tab
     setUpdatesEnabled(true);
     repaint();
     resize(oldSize);
@@ -477,46 +515,90 @@ void AppWindow::openTabs(const QStringList &paths)
 
 void AppWindow::openPaths(const QStringList &paths, bool cpp, bool java, bool python, int depth)
 {
+    TRACE_STARTUP("AppWindow::openPaths");
     LOG_INFO("Open Path with arguments " << BOOL_INFO_OF(cpp) << BOOL_INFO_OF(java) << BOOL_INFO_OF(python)
                                          << INFO_OF(depth) << INFO_OF(paths.join(" ")));
-    QStringList res;
+    QStringList files;
+    QStringList folders;
     for (auto const &path : paths)
     {
         if (QDir(path).exists())
-            res.append(openFolder(path, cpp, java, python, depth));
+            folders.append(path);
         else
-            res.append(path);
+            files.append(path);
     }
-    openTabs(res);
+    openTabs(files);
+    if (!folders.isEmpty())
+        openFolders(folders, cpp, java, python, depth);
 }
 
-QStringList AppWindow::openFolder(const QString &path, bool cpp, bool java, bool python, int depth)
+void AppWindow::openFolders(const QStringList &folders, bool cpp, bool java, bool python, int depth)
 {
-    LOG_INFO("Open folder with arguments " << BOOL_INFO_OF(cpp) << BOOL_INFO_OF(java) << BOOL_INFO_OF(python)
-                                           << INFO_OF(depth) << INFO_OF(path));
-    auto entries = QDir(path).entryInfoList(QDir::NoDotAndDotDot | QDir::AllEntries);
-    QStringList res;
-    for (auto &entry : entries)
-    {
-        if (entry.isDir())
-        {
-            if (depth > 0)
-                res.append(openFolder(entry.canonicalFilePath(), cpp, java, python, depth - 1));
-            else if (depth == -1)
-                res.append(openFolder(entry.canonicalFilePath(), cpp, java, python, -1));
-        }
-        else if ((cpp && Util::cppSuffix.contains(entry.suffix())) ||
-                 (java && Util::javaSuffix.contains(entry.suffix())) ||
-                 (python && Util::pythonSuffix.contains(entry.suffix())))
-        {
-            res.append(entry.canonicalFilePath());
-        }
-    }
-    return res;
+    QStringList suffixes;
+    if (cpp)
+        suffixes += Util::cppSuffix;
+    if (java)
+        suffixes += Util::javaSuffix;
+    if (python)
+        suffixes += Util::pythonSuffix;
+
+    auto *scanner = new Core::FolderScanner(suffixes, this);
+
+    // the dialog is only shown if the scan takes a while, and it doesn't block the tabs that are already opened
+    auto *progress = new QProgressDialog(tr("Scanning folders..."), tr("Cancel"), 0, 0, this);
+    progress->setWindowTitle(tr("Opening Folders"));
+    progress->setMinimumDuration(FOLDER_SCAN_PROGRESS_DELAY);
+    connect(progress, &QProgressDialog::canceled, scanner, &Core::FolderScanner::cancel);
+
+    connect(scanner, &Core::FolderScanner::filesFound, this,
+            [this, progress, opened = 0, last = QPointer<QWidget>()](const QStringList &paths) mutable {
+                // an empty untitled tab opened on startup is replaced by the files, like opening files directly
+                QPointer<MainWindow> emptyTab;
+                if (opened == 0 && ui->tabWidget->count() == 1 && placeholderAt(0) == nullptr)
+                {
+                    auto *window = windowAt(0);
+                    if (window->isUntitled() && window->getProblemURL().isEmpty() && !window->isTextChanged())
+                        emptyTab = window;
+                }
+
+                // the files are not untitled, so they can share an untitled index
+                const int untitledIndex = getNewUntitledIndex();
+                const int lastIndex = ui->tabWidget->indexOf(last);
+                int index = lastIndex != -1 ? lastIndex + 1 : ui->tabWidget->currentIndex() + 1;
+                for (auto const &path : paths)
+                {
+                    if (tabOfFile(path) != nullptr)
+                        continue;
+                    const auto language = Util::languageOfFile(path, SettingsHelper::getDefaultLanguage());
+                    auto *placeholder = new Widgets::TabPlaceholder(path, language, untitledIndex);
+                    ui->tabWidget->insertTab(index++, placeholder, placeholder->getTabTitle(false, true));
+                    updateTabIndex(placeholder);
+                    sessionManager->trackTab(placeholder);
+                    if (opened++ == 0)
+                        ui->tabWidget->setCurrentWidget(placeholder); // load the first file
+                    last = placeholder;
+                }
+
+                if (emptyTab && ui->tabWidget->count() > 1)
+                    closeTab(ui->tabWidget->indexOf(emptyTab));
+
+                progress->setLabelText(tr("Scanning folders... %n file(s) found", "", opened));
+                onEditorFileChanged();
+            });
+
+    connect(scanner, &Core::FolderScanner::finished, this, [scanner, progress](bool cancelled) {
+        LOG_INFO(BOOL_INFO_OF(cancelled));
+        progress->close();
+        progress->deleteLater();
+        scanner->deleteLater();
+    });
+
+    scanner->start(folders, depth);
 }
 
 void AppWindow::openContest(Widgets::ContestDialog::ContestData const &data)
 {
+    TRACE_STARTUP("AppWindow::openContest");
     const QString &path = data.path;
     const QString &lang = data.language;
     int number = data.number;
@@ -545,6 +627,7 @@ bool AppWindow::quit()
     {
         LOG_INFO("quit() with hotexit");
         sessionManager->updateSession();
+        sessionManager->waitForSessionSaved();
     }
     else
     {
@@ -564,12 +647,25 @@ bool AppWindow::quit()
     return true;
 }
 
+MainWindow *AppWindow::createWindow(const QString &path, int untitledIndex)
+{
+    auto *window = new MainWindow(path, untitledIndex, this);
+    window->setLanguage(Util::languageOfFile(path, SettingsHelper::getDefaultLanguage()));
+    return window;
+}
+
 int AppWindow::getNewUntitledIndex()
 {
     int index = 0;
     QSet<int> vis;
     for (int t = 0; t < ui->tabWidget->count(); ++t)
     {
+        if (auto *placeholder = placeholderAt(t))
+        {
+            if (placeholder->isUntitled() && placeholder->getProblemURL().isEmpty())
+                vis.insert(placeholder->getUntitledIndex());
+            continue;
+        }
         auto *tmp = windowAt(t);
         if (tmp->isUntitled() && tmp->getProblemURL().isEmpty())
         {
@@ -694,6 +790,9 @@ void AppWindow::on_actionSaveAll_triggered()
 {
     for (int t = 0; t < ui->tabWidget->count(); ++t)
     {
+        auto *placeholder = placeholderAt(t);
+        if (placeholder != nullptr && !placeholder->isUntitled() && !placeholder->isTextChanged())
+            continue; // there's nothing to save in a tab that is not loaded
         auto *tmp = windowAt(t);
         if (!tmp->save(true, tr("Save All")))
             break;
@@ -721,8 +820,11 @@ void AppWindow::on_actionCloseAll_triggered()
 void AppWindow::on_actionCloseSaved_triggered()
 {
     for (int t = 0; t < ui->tabWidget->count(); t++)
-        if (!windowAt(t)->isTextChanged() && closeTab(t))
+    {
+        auto *placeholder = placeholderAt(t);
+        if (!(placeholder != nullptr ? placeholder->isTextChanged() : windowAt(t)->isTextChanged()) && closeTab(t))
             --t;
+    }
 }
 
 /************************ PREFERENCES SECTION **********************/
@@ -775,7 +877,8 @@ void AppWindow::on_actionExportSession_triggered()
                                             tr("CP Editor Session File") + " (*.json)");
     if (!path.isEmpty())
     {
-        if (!Util::saveFile(path, sessionManager->currentSessionText(), "Export Session"))
+        if (!Util::saveFile(path, sessionManager->currentSessionText(), "Export Session", true, nullptr, false,
+                            Util::FileKind::Session))
         {
             QMessageBox::warning(this, tr("Export Session"),
                                  tr("Failed to export the current session to [%1]").arg(path));
@@ -859,16 +962,12 @@ void AppWindow::onTabChanged(int index)
     if (index == -1)
     {
         activeLogger = nullptr;
-        server->setMessageLogger(nullptr);
+        if (server != nullptr)
+            server->setMessageLogger(nullptr);
         findReplaceDialog->setTextEdit(nullptr);
         setWindowTitle(tr("CP Editor: An editor specially designed for competitive programming"));
 
-        if (cppServer->isDocumentOpen())
-            cppServer->closeDocument();
-        if (pythonServer->isDocumentOpen())
-            pythonServer->closeDocument();
-        if (javaServer->isDocumentOpen())
-            javaServer->closeDocument();
+        closeLanguageServerDocuments();
 
         return;
     }
@@ -885,7 +984,8 @@ void AppWindow::onTabChanged(int index)
     setWindowTitle(tmp->getCompleteTitle() + " - CP Editor");
 
     activeLogger = tmp->getLogger();
-    server->setMessageLogger(activeLogger);
+    if (server != nullptr)
+        server->setMessageLogger(activeLogger);
 
     if (ui->actionEditorMode->isChecked())
         on_actionEditorMode_triggered();
@@ -906,13 +1006,16 @@ void AppWindow::onTabChanged(int index)
 
 void AppWindow::onEditorFileChanged()
 {
+    if (isOpeningTabs)
+        return;
+
     if (currentWindow() != nullptr)
     {
         QMap<QString, QVector<int>> tabsByName;
 
         for (int t = 0; t < ui->tabWidget->count(); ++t)
         {
-            tabsByName[windowAt(t)->getTabTitle(false, false)].push_back(t);
+            tabsByName[tabTitleAt(t, false, false)].push_back(t);
         }
 
         for (auto tabs : tabsByName)
@@ -920,10 +1023,10 @@ void AppWindow::onEditorFileChanged()
             QString longestCommonPrefix;
             if (tabs.size() > 1)
             {
-                longestCommonPrefix = windowAt(tabs.front())->getCompleteTitle();
+                longestCommonPrefix = completeTitleAt(tabs.front());
                 for (int t = 1; t < tabs.length(); ++t)
                 {
-                    auto current = windowAt(tabs[t])->getCompleteTitle();
+                    auto current = completeTitleAt(tabs[t]);
                     longestCommonPrefix = longestCommonPrefix.left(current.length());
                     for (int i = 0; i < longestCommonPrefix.length(); ++i)
                     {
@@ -938,7 +1041,7 @@ void AppWindow::onEditorFileChanged()
             int removeLength = longestCommonPrefix.lastIndexOf('/') + 1;
             for (auto index : tabs)
             {
-                ui->tabWidget->setTabText(index, windowAt(index)->getTabTitle(tabs.size() > 1, true, removeLength));
+                ui->tabWidget->setTabText(index, tabTitleAt(index, tabs.size() > 1, true, removeLength));
             }
         }
 
@@ -977,12 +1080,9 @@ void AppWindow::updateLanguageServerFilePath(MainWindow *window, const QString &
 {
     if (currentWindow() == window)
     {
-        if (window->getLanguage() == "C++" && cppServer->isDocumentOpen())
-            cppServer->updatePath(path);
-        else if (window->getLanguage() == "Java" && javaServer->isDocumentOpen())
-            javaServer->updatePath(path);
-        else if (window->getLanguage() == "Python" && pythonServer->isDocumentOpen())
-            pythonServer->updatePath(path);
+        auto *languageServer = startedLanguageServer(window->getLanguage());
+        if (languageServer != nullptr && languageServer->isDocumentOpen())
+            languageServer->updatePath(path);
     }
 }
 
@@ -999,7 +1099,7 @@ void AppWindow::onLSPTimerElapsedCpp()
     if (tab == nullptr)
         return;
 
-    if (SettingsHelper::isLSPUseLintingCpp() && tab->getLanguage() == "C++")
+    if (cppServer != nullptr && SettingsHelper::isLSPUseLintingCpp() && tab->getLanguage() == "C++")
         cppServer->requestLinting();
 
     lspTimerCpp->stop();
@@ -1011,7 +1111,7 @@ void AppWindow::onLSPTimerElapsedJava()
     if (tab == nullptr)
         return;
 
-    if (SettingsHelper::isLSPUseLintingJava() && tab->getLanguage() == "Java")
+    if (javaServer != nullptr && SettingsHelper::isLSPUseLintingJava() && tab->getLanguage() == "Java")
         javaServer->requestLinting();
 
     lspTimerJava->stop();
@@ -1023,7 +1123,7 @@ void AppWindow::onLSPTimerElapsedPython()
     if (tab == nullptr)
         return;
 
-    if (SettingsHelper::isLSPUseLintingPython() && tab->getLanguage() == "Python")
+    if (pythonServer != nullptr && SettingsHelper::isLSPUseLintingPython() && tab->getLanguage() == "Python")
         pythonServer->requestLinting();
 
     lspTimerPython->stop();
@@ -1031,10 +1131,13 @@ void AppWindow::onLSPTimerElapsedPython()
 
 void AppWindow::onSettingsApplied(const QString &pagePath)
 {
+    TRACE_STARTUP("AppWindow::onSettingsApplied", pagePath);
     LOG_INFO("Apply settings for " << INFO_OF(pagePath));
 
     for (int i = 0; i < ui->tabWidget->count(); ++i)
     {
+        if (placeholderAt(i) != nullptr)
+            continue; // the settings will be applied when it's loaded
         windowAt(i)->applySettings(pagePath);
         onEditorTextChanged(windowAt(i));
     }
@@ -1048,7 +1151,7 @@ void AppWindow::onSettingsApplied(const QString &pagePath)
     if (pageChanged("Key Bindings"))
         maybeSetHotkeys();
 
-    if (pageChanged("Extensions/Competitive Companion"))
+    if (server != nullptr && pageChanged("Extensions/Competitive Companion"))
     {
         if (SettingsHelper::isCompetitiveCompanionEnable())
             server->updatePort(SettingsHelper::getCompetitiveCompanionConnectionPort());
@@ -1057,10 +1160,10 @@ void AppWindow::onSettingsApplied(const QString &pagePath)
     }
 
     if (pageChanged("Appearance/General"))
-    {
         setWindowOpacity(SettingsHelper::getOpacity() / 100.0);
+
+    if (pagePath.isEmpty()) // otherwise it's re-applied only when the UI style is changed, see setConnections()
         Core::StyleManager::setStyle(SettingsHelper::getUIStyle());
-    }
 
     if (pageChanged("Appearance/Font"))
     {
@@ -1071,22 +1174,13 @@ void AppWindow::onSettingsApplied(const QString &pagePath)
     }
 
     if (pageChanged("Extensions/Language Server/C++ Server"))
-    {
-        cppServer->updateSettings();
         lspTimerCpp->setInterval(SettingsHelper::getLSPDelayCpp());
-    }
 
     if (pageChanged("Extensions/Language Server/Java Server"))
-    {
-        javaServer->updateSettings();
         lspTimerJava->setInterval(SettingsHelper::getLSPDelayJava());
-    }
 
     if (pageChanged("Extensions/Language Server/Python Server"))
-    {
-        pythonServer->updateSettings();
         lspTimerPython->setInterval(SettingsHelper::getLSPDelayPython());
-    }
 
     if (pageChanged("Actions/Save Session"))
     {
@@ -1104,17 +1198,82 @@ void AppWindow::onSettingsApplied(const QString &pagePath)
 
 void AppWindow::onIncomingCompanionRequest(const Extensions::CompanionData &data)
 {
-    LOG_INFO("Request from competitive companion arrived");
+    LOG_INFO("Request from competitive companion arrived " << INFO_OF(data.url));
 
-    for (int i = 0; i < ui->tabWidget->count(); ++i)
+    // Competitive Companion sends one request per problem when a contest is parsed, so the requests are queued and
+    // imported together, and a problem sent again replaces the queued one
+    for (auto &queued : companionQueue)
     {
-        if (windowAt(i)->getProblemURL() == data.url)
+        if (queued.url == data.url)
         {
-            ui->tabWidget->setCurrentIndex(i);
-            currentWindow()->applyCompanion(data);
+            queued = data;
+            companionTimer->start();
             return;
         }
     }
+    companionQueue.push_back(data);
+
+    companionTimer->start();
+}
+
+void AppWindow::processCompanionQueue()
+{
+    const auto queue = companionQueue;
+    companionQueue.clear();
+
+    LOG_INFO(INFO_OF(queue.size()));
+
+    // each request replaces the problem in the current tab if new tabs are not opened
+    if (queue.size() == 1 || !SettingsHelper::isCompetitiveCompanionOpenNewTab())
+    {
+        for (const auto &data : queue)
+            applyCompanionRequest(data);
+        return;
+    }
+
+    QVector<QPair<QString, Extensions::CompanionData>> newProblems;
+    for (const auto &data : queue)
+    {
+        QString path;
+        if (SettingsHelper::isOpenOldFileForOldProblemUrl() && FileProblemBinder::containsProblem(data.url))
+        {
+            auto oldFile = FileProblemBinder::getFileForProblem(data.url);
+            if (QFileInfo(oldFile).isReadable())
+                path = oldFile;
+        }
+
+        if (tabOfProblem(data.url) != nullptr || (!path.isEmpty() && tabOfFile(path) != nullptr))
+            applyCompanionRequest(data); // the problem is already opened
+        else
+            newProblems.push_back({path, data});
+    }
+
+    if (newProblems.isEmpty())
+        return;
+
+    int index = ui->tabWidget->currentIndex() + 1;
+    const int firstIndex = index;
+    for (const auto &problem : newProblems)
+    {
+        auto *placeholder = new Widgets::TabPlaceholder(companionPlaceholderStatus(problem.first, problem.second),
+                                                        problem.second);
+        ui->tabWidget->insertTab(index++, placeholder, placeholder->getTabTitle(false, true));
+        updateTabIndex(placeholder);
+        sessionManager->trackTab(placeholder);
+    }
+
+    ui->tabWidget->setCurrentIndex(firstIndex); // load the first problem
+    onEditorFileChanged();
+}
+
+void AppWindow::applyCompanionRequest(const Extensions::CompanionData &data)
+{
+    if (auto *tab = tabOfProblem(data.url))
+    {
+        ui->tabWidget->setCurrentWidget(tab);
+        currentWindow()->applyCompanion(data);
+        return;
+    }
 
     do
     {
@@ -1134,6 +1293,99 @@ void AppWindow::onIncomingCompanionRequest(const Extensions::CompanionData &data
     currentWindow()->applyCompanion(data);
 }
 
+MainWindow::EditorStatus AppWindow::companionPlaceholderStatus(const QString &path,
+                                                               const Extensions::CompanionData &data)
+{
+    MainWindow::EditorStatus status;
+    status.timestamp = QDateTime::currentMSecsSinceEpoch();
+    status.filePath = path;
+    status.problemURL = data.url;
+    status.untitledIndex = getNewUntitledIndex();
+    status.isLanguageSet = true;
+    status.language = Util::languageOfFile(path, SettingsHelper::getDefaultLanguage());
+
+    // the session restores the file, or the template for a new tab, with the test cases of the problem
+    const auto textPath =
+        path.isEmpty() ? SettingsManager::get(QString("%1/Template Path").arg(status.language)).toString() : path;
+    if (!textPath.isEmpty())
+        status.savedText = status.editorText = Util::readFile(textPath, tr("Open File"), nullptr);
+
+    status.customTimeLimit = SettingsHelper::isCompetitiveCompanionSetTimeLimitForTab() ? data.timeLimit : -1;
+    for (const auto &testcase : data.testcases)
+    {
+        status.input.push_back(testcase.input);
+        status.expected.push_back(testcase.output);
+        status.testcasesIsShow.push_back(true);
+    }
+    return status;
+}
+
+QWidget *AppWindow::tabOfProblem(const QString &url) const
+{
+    if (url.isEmpty())
+        return nullptr;
+    return tabsByProblemURL.value(url);
+}
+
+QWidget *AppWindow::tabOfFile(const QString &path) const
+{
+    if (path.isEmpty())
+        return nullptr;
+    return tabsByFilePath.value(tabPathKey(path));
+}
+
+void AppWindow::updateTabIndex(QWidget *tab)
+{
+    QString path;
+    QString url;
+    if (auto *placeholder = qobject_cast<Widgets::TabPlaceholder *>(tab))
+    {
+        path = placeholder->getFilePath();
+        url = placeholder->getProblemURL();
+    }
+    else if (auto *window = qobject_cast<MainWindow *>(tab))
+    {
+        path = window->getFilePath();
+        url = window->getProblemURL();
+    }
+    else
+    {
+        return;
+    }
+
+    auto it = tabKeys.find(tab);
+    if (it == tabKeys.end())
+    {
+        it = tabKeys.insert(tab, {});
+        connect(tab, &QObject::destroyed, this, [this, tab] {
+            const auto keys = tabKeys.take(tab);
+            tabsByFilePath.remove(keys.first, tab);
+            tabsByProblemURL.remove(keys.second, tab);
+        });
+    }
+    else
+    {
+        tabsByFilePath.remove(it->first, tab);
+        tabsByProblemURL.remove(it->second, tab);
+    }
+
+    *it = {path.isEmpty() ? QString() : tabPathKey(path), url};
+    if (!it->first.isEmpty())
+        tabsByFilePath.insert(it->first, tab);
+    if (!it->second.isEmpty())
+        tabsByProblemURL.insert(it->second, tab);
+}
+
+QString AppWindow::tabPathKey(const QString &path)
+{
+    const QFileInfo fileInfo(path);
+    auto key = fileInfo.exists() ? fileInfo.canonicalFilePath() : path;
+#ifdef Q_OS_WIN
+    key = key.toLower(); // file paths are case insensitive on Windows, which is also how QFileInfo compares them
+#endif
+    return key;
+}
+
 void AppWindow::onViewModeToggle()
 {
     LOG_INFO("Switching view mode");
@@ -1171,34 +1423,14 @@ void AppWindow::openTab(const QString &path, MainWindow *after)
     LOG_INFO("OpenTab Path is " << path);
     if (!path.isEmpty())
     {
-        auto fileInfo = QFileInfo(path);
-        for (int t = 0; t < ui->tabWidget->count(); t++)
+        if (auto *tab = tabOfFile(path))
         {
-            auto tPath = qobject_cast<MainWindow *>(ui->tabWidget->widget(t))->getFilePath();
-            if (path == tPath || (fileInfo.exists() && fileInfo == QFileInfo(tPath)))
-            {
-                ui->tabWidget->setCurrentIndex(t);
-                return;
-            }
+            ui->tabWidget->setCurrentWidget(tab);
+            return;
         }
     }
 
-    auto *newWindow = new MainWindow(path, getNewUntitledIndex(), this);
-
-    QString lang = SettingsHelper::getDefaultLanguage();
-
-    auto suffix = QFileInfo(path).suffix();
-
-    if (Util::cppSuffix.contains(suffix))
-        lang = "C++";
-    else if (Util::javaSuffix.contains(suffix))
-        lang = "Java";
-    else if (Util::pythonSuffix.contains(suffix))
-        lang = "Python";
-
-    newWindow->setLanguage(lang);
-
-    openTab(newWindow, after);
+    openTab(createWindow(path, getNewUntitledIndex()), after);
 }
 
 /************************* ACTIONS ************************/
@@ -1426,12 +1658,12 @@ void AppWindow::onTabContextMenuRequested(const QPoint &pos)
 
         tabMenu->addAction(tr("Close Others"), [window, this] {
             for (int i = 0; i < ui->tabWidget->count(); ++i)
-                if (windowAt(i) != window && closeTab(i))
+                if (ui->tabWidget->widget(i) != window && closeTab(i))
                     --i;
         });
 
         tabMenu->addAction(tr("Close to the Left"), [window, this] {
-            for (int i = 0; i < ui->tabWidget->count() && windowAt(i) != window; ++i)
+            for (int i = 0; i < ui->tabWidget->count() && ui->tabWidget->widget(i) != window; ++i)
                 if (closeTab(i))
                     --i;
         });
@@ -1457,6 +1689,13 @@ void AppWindow::onTabContextMenuRequested(const QPoint &pos)
 
         tabMenu->addAction(tr("Set Time Limit"), [window] { window->updateTimeLimit(); });
 
+        tabMenu->addAction(tr("Set Interactor"), [window] { window->updateInteractor(); });
+
+        if (!window->getInteractorPath().isEmpty())
+            tabMenu->addAction(tr("Remove Interactor"), [window] { window->setInteractorPath(QString()); });
+
+        tabMenu->addAction(tr("Set File I/O"), [window] { window->updateFileIO(); });
+
         LOG_INFO(INFO_OF(filePath));
 
         const auto outputFilePath =
@@ -1520,12 +1759,7 @@ void AppWindow::onTabContextMenuRequested(const QPoint &pos)
 
 MainWindow *AppWindow::currentWindow()
 {
-    int current = ui->tabWidget->currentIndex();
-    if (current == -1)
-    {
-        return nullptr;
-    }
-    return qobject_cast<MainWindow *>(ui->tabWidget->widget(current));
+    return windowAt(ui->tabWidget->currentIndex());
 }
 
 void AppWindow::reAttachLanguageServer(MainWindow *window)
@@ -1535,42 +1769,160 @@ void AppWindow::reAttachLanguageServer(MainWindow *window)
     lspTimerJava->stop();
     lspTimerPython->stop();
 
-    if (cppServer->isDocumentOpen())
-        cppServer->closeDocument();
-    if (javaServer->isDocumentOpen())
-        javaServer->closeDocument();
-    if (pythonServer->isDocumentOpen())
-        pythonServer->closeDocument();
+    closeLanguageServerDocuments();
+
+    if (!deferredServicesStarted)
+        return; // the language server will be attached in startDeferredServices()
+
+    auto *languageServer = startLanguageServer(window->getLanguage());
+    if (languageServer == nullptr)
+        return;
+
+    languageServer->openDocument(window->filePathOrTmpPath(), window->getEditor(), window->getLogger());
+    languageServer->requestLinting();
 
     if (window->getLanguage() == "C++")
-    {
-        cppServer->openDocument(window->filePathOrTmpPath(), window->getEditor(), window->getLogger());
-        cppServer->requestLinting();
         lspTimerCpp->start();
-    }
     else if (window->getLanguage() == "Java")
-    {
-        javaServer->openDocument(window->filePathOrTmpPath(), window->getEditor(), window->getLogger());
-        javaServer->requestLinting();
         lspTimerJava->start();
+    else
+        lspTimerPython->start();
+}
+
+Extensions::LanguageServer *AppWindow::startedLanguageServer(const QString &language) const
+{
+    if (language == "C++")
+        return cppServer;
+    if (language == "Java")
+        return javaServer;
+    if (language == "Python")
+        return pythonServer;
+    return nullptr;
+}
+
+Extensions::LanguageServer *AppWindow::startLanguageServer(const QString &language)
+{
+    Extensions::LanguageServer **languageServer = nullptr;
+    if (language == "C++")
+        languageServer = &cppServer;
+    else if (language == "Java")
+        languageServer = &javaServer;
+    else if (language == "Python")
+        languageServer = &pythonServer;
+    else
+        return nullptr;
+
+    if (*languageServer == nullptr)
+    {
+        LOG_INFO("Starting the language server for " << language);
+        *languageServer = new Extensions::LanguageServer(language);
     }
-    else if (window->getLanguage() == "Python")
+    return *languageServer;
+}
+
+void AppWindow::closeLanguageServerDocuments()
+{
+    for (auto *languageServer : {cppServer, javaServer, pythonServer})
     {
-        pythonServer->openDocument(window->filePathOrTmpPath(), window->getEditor(), window->getLogger());
-        pythonServer->requestLinting();
-        lspTimerPython->start();
+        if (languageServer != nullptr && languageServer->isDocumentOpen())
+            languageServer->closeDocument();
     }
 }
 
+void AppWindow::startDeferredServices()
+{
+    if (deferredServicesStarted)
+        return;
+    deferredServicesStarted = true;
+
+    LOG_INFO("Starting the deferred services");
+
+    server = new Extensions::CompanionServer(SettingsHelper::isCompetitiveCompanionEnable()
+                                                 ? SettingsHelper::getCompetitiveCompanionConnectionPort()
+                                                 : 0);
+    server->setMessageLogger(activeLogger);
+    connect(server, &Extensions::CompanionServer::onRequestArrived, this, &AppWindow::onIncomingCompanionRequest);
+
+    auto *window = currentWindow();
+    if (window != nullptr)
+        reAttachLanguageServer(window);
+
+    if (SettingsHelper::isCheckUpdate())
+        updateChecker->checkUpdate(true);
+}
+
 MainWindow *AppWindow::windowAt(int index)
 {
     if (index == -1)
     {
         return nullptr;
     }
+
+    if (auto *placeholder = placeholderAt(index))
+    {
+        LOG_INFO("Loading the tab at " << index);
+
+        MainWindow *window = nullptr;
+        if (placeholder->hasCompanionData())
+        {
+            window = createWindow(placeholder->getFilePath(), placeholder->getUntitledIndex());
+            window->applyCompanion(placeholder->getCompanionData());
+        }
+        else if (placeholder->hasPendingFile())
+        {
+            window = createWindow(placeholder->getFilePath(), placeholder->getUntitledIndex());
+        }
+        else
+        {
+            auto status = placeholder->getStatus();
+            if (placeholder->hasSessionStatus())
+            {
+                status = MainWindow::EditorStatus(
+                    Core::SessionManager::loadBlobs(placeholder->getSessionStatus(), placeholder->getBlobDirectory()));
+            }
+            window = new MainWindow(status, false, placeholder->getUntitledIndex(), this);
+        }
+        connectWindow(window);
+
+        {
+            // replace the placeholder by the window without changing the current tab
+            const QSignalBlocker blocker(ui->tabWidget);
+            const bool isCurrent = ui->tabWidget->currentIndex() == index;
+            const auto tabText = ui->tabWidget->tabText(index);
+            ui->tabWidget->removeTab(index);
+            ui->tabWidget->insertTab(index, window, tabText);
+            if (isCurrent)
+                ui->tabWidget->setCurrentIndex(index);
+        }
+        updateTabIndex(window); // the placeholder is removed from the indexes when it's deleted
+
+        delete placeholder;
+        onEditorTextChanged(window); // the placeholder doesn't know whether the file is changed on the disk
+        return window;
+    }
+
     return qobject_cast<MainWindow *>(ui->tabWidget->widget(index));
 }
 
+Widgets::TabPlaceholder *AppWindow::placeholderAt(int index)
+{
+    return qobject_cast<Widgets::TabPlaceholder *>(ui->tabWidget->widget(index));
+}
+
+QString AppWindow::tabTitleAt(int index, bool complete, bool star, int removeLength)
+{
+    if (auto *placeholder = placeholderAt(index))
+        return placeholder->getTabTitle(complete, star, removeLength);
+    return windowAt(index)->getTabTitle(complete, star, removeLength);
+}
+
+QString AppWindow::completeTitleAt(int index)
+{
+    if (auto *placeholder = placeholderAt(index))
+        return placeholder->getCompleteTitle();
+    return windowAt(index)->getCompleteTitle();
+}
+
 void AppWindow::on_actionShowLogs_triggered() // NOLINT: Method can be made static
 {
     Core::Log::revealInFileManager();
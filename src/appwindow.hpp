@@ -20,6 +20,7 @@
 
 #include "Widgets/ContestDialog.hpp"
 #include "mainwindow.hpp"
+#include <QHash>
 #include <QMainWindow>
 #include <QSystemTrayIcon>
 
@@ -54,6 +55,11 @@ namespace Core
 class SessionManager;
 }
 
+namespace Widgets
+{
+class TabPlaceholder;
+}
+
 class AppWindow : public QMainWindow
 {
     Q_OBJECT
@@ -76,6 +82,7 @@ class AppWindow : public QMainWindow
     void dropEvent(QDropEvent *event) override;
     void dragEnterEvent(QDragEnterEvent *event) override;
     void changeEvent(QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
 
   public slots:
     void onReceivedMessage(quint32 instanceId, QByteArray message);
@@ -249,6 +256,20 @@ class AppWindow : public QMainWindow
 
     std::atomic_bool _isInitialized{false};
 
+    bool deferredServicesStarted = false; // whether startDeferredServices() is called
+    bool isOpeningTabs = false;           // whether openTabs() is running, the tab titles are updated after that
+
+    QVector<Extensions::CompanionData> companionQueue; // the Competitive Companion requests waiting to be imported
+    QTimer *companionTimer = nullptr;                  // imports the queued requests when no more requests arrive
+
+    QMultiHash<QString, QWidget *> tabsByFilePath;     // the tabs (windows or placeholders) by tabPathKey()
+    QMultiHash<QString, QWidget *> tabsByProblemURL;   // the tabs (windows or placeholders) by problem URLs
+    QHash<QWidget *, QPair<QString, QString>> tabKeys; // the keys of a tab in tabsByFilePath and tabsByProblemURL
+
+    const static int DEFERRED_SERVICES_TIMEOUT = 3000;  // start the deferred services if not painted in this time (ms)
+    const static int COMPANION_BATCH_INTERVAL = 300;    // the requests arriving in this interval are one batch (ms)
+    const static int FOLDER_SCAN_PROGRESS_DELAY = 1000; // show the progress of a folder scan after this time (ms)
+
     explicit AppWindow(bool noRestoreSession, QWidget *parent = nullptr);
 
     void finishConstruction();
@@ -260,20 +281,107 @@ class AppWindow : public QMainWindow
     QVector<QShortcut *> hotkeyObjects;
     void maybeSetHotkeys();
     bool closeTab(int index);
+    void connectWindow(MainWindow *window);
     void openTab(MainWindow *window, MainWindow *after = nullptr);
     void openTab(const MainWindow::EditorStatus &status, bool duplicate = false, MainWindow *after = nullptr);
     void openTabs(const QStringList &paths);
     void openPaths(const QStringList &paths, bool cpp = true, bool java = true, bool python = true, int depth = -1);
-    QStringList openFolder(const QString &path, bool cpp, bool java, bool python, int depth);
+
+    /**
+     * @brief scan the folders on a worker thread, and open the files found as placeholders of lazily loaded tabs
+     * @param depth the depth of the sub-folders to scan, -1 for unlimited
+     * @note The scan can be cancelled in the progress dialog, which is shown if the scan takes a while.
+     */
+    void openFolders(const QStringList &folders, bool cpp, bool java, bool python, int depth);
+
     void openContest(Widgets::ContestDialog::ContestData const &data);
     bool quit();
     int getNewUntitledIndex();
+
+    /**
+     * @brief create a MainWindow of a file, or a new untitled tab if the path is empty
+     */
+    MainWindow *createWindow(const QString &path, int untitledIndex);
+
+    /**
+     * @brief import the queued Competitive Companion requests
+     * @note A single request is applied at once. When a contest is parsed, the problems that are not opened yet are
+     * added as placeholders, which load the files and apply the problems when they are activated.
+     */
+    void processCompanionQueue();
+    void applyCompanionRequest(const Extensions::CompanionData &data);
+
+    /**
+     * @brief the status saved in the session for a problem imported in a batch before its tab is loaded
+     */
+    MainWindow::EditorStatus companionPlaceholderStatus(const QString &path, const Extensions::CompanionData &data);
+
+    /**
+     * @brief find the tab of a problem URL or a file path without loading the tabs
+     * @returns the MainWindow or TabPlaceholder of the tab, or nullptr if it's not found
+     * @note They look up tabsByProblemURL and tabsByFilePath, without checking the tabs one by one. If several tabs
+     *       match, e.g. a problem opened in a duplicated tab, the one indexed last is returned.
+     */
+    QWidget *tabOfProblem(const QString &url) const;
+    QWidget *tabOfFile(const QString &path) const;
+
+    /**
+     * @brief update the file path and problem URL of a tab in the lookup indexes
+     * @param tab a MainWindow or a TabPlaceholder in the tab widget
+     * @note This should be called when a tab is added, and when its file path or problem URL is changed.
+     *       A tab is removed from the indexes when it's destroyed.
+     */
+    void updateTabIndex(QWidget *tab);
+
+    /**
+     * @brief the key of a file path in tabsByFilePath
+     * @note It's the canonical path if the file exists, so that different paths to the same file have the same key.
+     */
+    static QString tabPathKey(const QString &path);
     void reAttachLanguageServer(MainWindow *window);
+
+    /**
+     * @brief get the language server of a language
+     * @returns nullptr if it's not started yet or the language is unknown
+     */
+    Extensions::LanguageServer *startedLanguageServer(const QString &language) const;
+
+    /**
+     * @brief get the language server of a language, start it if it's not started yet
+     * @returns nullptr if the language is unknown
+     */
+    Extensions::LanguageServer *startLanguageServer(const QString &language);
+
+    void closeLanguageServerDocuments();
+
+    /**
+     * @brief start the Competitive Companion server, the update check and the language server of the current tab
+     * @note These are deferred until the window is shown, so that they don't slow down the startup.
+     * The other language servers are started when a tab in their languages is focused for the first time.
+     */
+    void startDeferredServices();
     void triggerWakaTime(MainWindow *window, bool isWrite = false);
 
     MainWindow *currentWindow();
+
+    /**
+     * @brief get the MainWindow of a tab
+     * @note If the tab is not loaded yet, it will be loaded. Use placeholderAt() to avoid loading it.
+     */
     MainWindow *windowAt(int index);
 
+    /**
+     * @brief get the placeholder of a tab
+     * @returns the placeholder if the tab is not loaded yet, nullptr otherwise
+     */
+    Widgets::TabPlaceholder *placeholderAt(int index);
+
+    /**
+     * @brief get the titles of a tab without loading it
+     */
+    QString tabTitleAt(int index, bool complete, bool star, int removeLength = 0);
+    QString completeTitleAt(int index);
+
     friend class Core::SessionManager;
 };
 
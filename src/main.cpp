@@ -16,10 +16,14 @@
  */
 
 #include "Core/EventLogger.hpp"
+#include "Core/Judge.hpp"
+#include "Core/StartupTracer.hpp"
 #include "Core/Translator.hpp"
 #include "Settings/SettingsInfo.hpp"
 #include "SignalHandler.hpp"
+#include "Util/FileUtil.hpp"
 #include "Util/Util.hpp"
+#include "Widgets/TestCases.hpp"
 #include "application.hpp"
 #include "appwindow.hpp"
 #include "generated/SettingsHelper.hpp"
@@ -35,6 +39,9 @@
 #include <QJsonObject>
 #include <QProgressDialog>
 #include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <functional>
 #include <iostream>
 
 #ifdef Q_OS_WIN
@@ -43,9 +50,128 @@
 
 #define TOJSON(x) json[#x] = x
 
+/**
+ * @brief judge source files with their saved test cases without the GUI, and print a JSON report for each file
+ * @note It's not a SingleApplication, so it doesn't talk to a running CP Editor, and it doesn't need a display.
+ * @returns 0 if all files are accepted, 1 if some files are not accepted, 2 if the arguments are invalid
+ */
+static int runJudge(int argc, char *argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen"); // no window is shown, so it runs on a machine without a display
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("cpeditor");
+    QApplication::setApplicationVersion(DISPLAY_VERSION);
+
+    QTextStream cout(stdout, QIODevice::WriteOnly);
+    QTextStream cerr(stderr, QIODevice::WriteOnly);
+
+    QCommandLineParser parser;
+    parser.addVersionOption();
+    parser.addHelpOption();
+    parser.setApplicationDescription(
+        QString(argv[0]) + " --judge [options] <file1> [<file2> [...]]\n" +
+        "Compile each file, run it on its saved test cases and check the outputs, with the settings of CP Editor.\n" +
+        "A JSON report is printed in a line for each file when it's judged.");
+    parser.addOptions({{"judge", "Run the command line judge."},
+                       {"checker",
+                        "The checker, one of " + Core::Judge::checkerNames().join(", ") +
+                            ", or the path to a custom checker.",
+                        "checker", Core::Judge::checkerNames().first()},
+                       {"time-limit", "The time limit of each test case (ms). The default time limit if not specified.",
+                        "ms"},
+                       {"language", "The language of the files (C++, Java or Python). Detected by the suffixes if not "
+                                    "specified.",
+                        "language"},
+                       {{"j", "jobs"}, "The number of files judged at the same time.", "jobs",
+                        QString::number(QThread::idealThreadCount())},
+                       {"verbose", "Dump all logs to stderr of the application. (use only for debug purpose)"},
+                       {"log-level", "Set which logs are written, see the help of the GUI mode.", "rules"}});
+    parser.setSingleDashWordOptionMode(QCommandLineParser::ParseAsLongOptions);
+    parser.process(app);
+
+    if (parser.isSet("log-level") && !Core::Log::setFilterRules(parser.value("log-level")))
+    {
+        cerr << "Invalid log level rules: " << parser.value("log-level") << "\n";
+        return 2;
+    }
+
+    Core::Log::init(static_cast<unsigned int>(QCoreApplication::applicationPid()), parser.isSet("verbose"));
+    SettingsInfo::updateSettingInfo();
+    SettingsManager::init();
+
+    const auto files = parser.positionalArguments();
+    bool ok = true;
+    const int timeLimit =
+        parser.isSet("time-limit") ? parser.value("time-limit").toInt(&ok) : SettingsHelper::getDefaultTimeLimit();
+    if (!ok || timeLimit <= 0)
+    {
+        cerr << "The time limit should be a positive integer.\n";
+        return 2;
+    }
+    const int jobs = parser.value("jobs").toInt(&ok);
+    if (!ok || jobs <= 0)
+    {
+        cerr << "The number of jobs should be a positive integer.\n";
+        return 2;
+    }
+    if (files.isEmpty())
+    {
+        cerr << "No file to judge.\n\n"
+             << "See " << argv[0] << " --judge --help for more infomation.\n";
+        return 2;
+    }
+
+    LOG_INFO("Judging " << INFO_OF(files.size()) << INFO_OF(jobs));
+
+    int next = 0;
+    int running = 0;
+    int exitCode = 0;
+    std::function<void()> startNext = [&] {
+        while (running < jobs && next < files.size())
+        {
+            const auto file = QFileInfo(files[next++]).absoluteFilePath();
+            auto lang = parser.isSet("language") ? parser.value("language") : Util::languageOfFile(file, QString());
+            auto testCases = QVector<Core::Judge::TestCase>();
+            for (const auto &test : Widgets::TestCases::readSavedFiles(file))
+                testCases.push_back({test.first, test.second});
+
+            auto *judge = new Core::Judge(&app);
+            QObject::connect(judge, &Core::Judge::finished, &app, [&, judge](const QJsonObject &report) {
+                cout << QJsonDocument(report).toJson(QJsonDocument::Compact) << "\n";
+                cout.flush();
+                if (!report["accepted"].toBool())
+                    exitCode = 1;
+                judge->deleteLater();
+                --running;
+                if (running == 0 && next == files.size())
+                    QCoreApplication::exit(exitCode);
+                else
+                    startNext();
+            });
+            ++running;
+            judge->start(file, lang, testCases, timeLimit, parser.value("checker"));
+        }
+    };
+    QTimer::singleShot(0, &app, startNext);
+
+    return QApplication::exec();
+}
+
 int main(int argc, char *argv[])
 {
+    // the command line judge doesn't start the GUI, so it's checked before creating the application
+    for (int i = 1; i < argc; ++i)
+    {
+        if (qstrcmp(argv[i], "--judge") == 0 || qstrcmp(argv[i], "-judge") == 0)
+            return runJudge(argc, argv);
+    }
+
+    Core::StartupTracer::start();
+    Core::StartupTracer::Scope applicationScope("Application::Application");
     Application app(argc, argv);
+    applicationScope.end();
     SingleApplication::setApplicationName("cpeditor");
     SingleApplication::setApplicationVersion(DISPLAY_VERSION);
     QApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
@@ -133,7 +259,17 @@ int main(int argc, char *argv[])
          {"python", "Open Python files in given directories. / Use Python for open contests."},
          {"verbose", "Dump all logs to stderr of the application. (use only for debug purpose)"},
          {"no-restore-session",
-          "Do not load hot exit in this session. You won't be able to load the last session again."}});
+          "Do not load hot exit in this session. You won't be able to load the last session again."},
+         {"trace-startup",
+          "Write the timings of the startup into <file> in the Chrome trace-event format. (use only for debug purpose)",
+          "file"},
+         {"judge", "Judge files without the GUI, see --judge --help for more information."},
+         {"log-level",
+          "Set which logs are written, e.g. \"warn,CompanionServer=debug\". The levels are debug, info, warn, error, "
+          "wtf and off, and a module is the name of the source file. (use only for debug purpose)",
+          "rules"},
+         {"keep-debug-logs", "Keep the recent debug logs in memory, and write them into the log file when the "
+                             "application crashes. (use only for debug purpose)"}});
     parser.setOptionsAfterPositionalArgumentsMode(QCommandLineParser::ParseAsOptions);
     parser.setSingleDashWordOptionMode(QCommandLineParser::ParseAsLongOptions);
     parser.process(app);
@@ -147,11 +283,25 @@ int main(int argc, char *argv[])
     bool noRestoreSession = parser.isSet("no-restore-session");
     bool shouldDumpTostderr = parser.isSet("verbose");
 
+    if (parser.isSet("trace-startup"))
+        Core::StartupTracer::setOutputPath(QDir::current().absoluteFilePath(parser.value("trace-startup")));
+
+    if (parser.isSet("log-level") && !Core::Log::setFilterRules(parser.value("log-level")))
+    {
+        cerr << "Invalid log level rules: " << parser.value("log-level") << "\n\n"
+             << "See " + programName + " --help for more infomation.\n\n";
+        return 1;
+    }
+    Core::Log::setDebugRecordsKept(parser.isSet("keep-debug-logs"));
+
     auto instance = app.instanceId();
     Core::Log::init(instance, shouldDumpTostderr);
     LOG_INFO(INFO_OF(instance));
 
-    SettingsInfo::updateSettingInfo(); // generate an English version, so that we can use SettingsHelper
+    {
+        TRACE_STARTUP("SettingsInfo::updateSettingInfo");
+        SettingsInfo::updateSettingInfo(); // generate an English version, so that we can use SettingsHelper
+    }
     SettingsManager::init();
     Core::Translator::setLocale();
 
@@ -224,6 +374,7 @@ int main(int argc, char *argv[])
         LOG_INFO("Launched window connecting this window to onReceiveMessage()");
         QObject::connect(&app, &SingleApplication::receivedMessage, &w, &AppWindow::onReceivedMessage);
         LOG_INFO("Showing the application window and beginning the event loop");
+        Core::StartupTracer::finishOnFirstPaint(&w);
         w.show();
         return SingleApplication::exec();
     }
@@ -279,6 +430,7 @@ int main(int argc, char *argv[])
     QObject::connect(&app, &SingleApplication::receivedMessage, &w, &AppWindow::onReceivedMessage);
     LOG_INFO("Showing the application window and beginning the event loop");
 
+    Core::StartupTracer::finishOnFirstPaint(&w);
     w.show();
     return SingleApplication::exec();
 }
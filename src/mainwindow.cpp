@@ -20,8 +20,10 @@
 #include "Core/Checker.hpp"
 #include "Core/Compiler.hpp"
 #include "Core/EventLogger.hpp"
+#include "Core/FileWatcher.hpp"
 #include "Core/MessageLogger.hpp"
 #include "Core/Runner.hpp"
+#include "Core/StartupTracer.hpp"
 #include "Editor/CodeEditor.hpp"
 #include "Extensions/CFTool.hpp"
 #include "Extensions/ClangFormatter.hpp"
@@ -30,13 +32,14 @@
 #include "Settings/DefaultPathManager.hpp"
 #include "Settings/FileProblemBinder.hpp"
 #include "Settings/PreferencesWindow.hpp"
+#include "Settings/SettingsManager.hpp"
 #include "Util/FileUtil.hpp"
 #include "Widgets/Stopwatch.hpp"
 #include "Widgets/TestCases.hpp"
 #include "appwindow.hpp"
 #include "generated/SettingsHelper.hpp"
 #include "generated/version.hpp"
-#include <QFileSystemWatcher>
+#include <QCryptographicHash>
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QMimeData>
@@ -50,13 +53,21 @@
 
 static const int MAX_NUMBER_OF_RECENT_FILES = 20;
 
+static QByteArray textHash(const QString &text)
+{
+    return QCryptographicHash::hash(QByteArray::fromRawData(reinterpret_cast<const char *>(text.constData()),
+                                                            text.size() * static_cast<int>(sizeof(QChar))),
+                                    QCryptographicHash::Sha1);
+}
+
 // ***************************** RAII  ****************************
 
 MainWindow::MainWindow(int index, AppWindow *parent)
     : QMainWindow(parent), ui(new Ui::MainWindow), editor(nullptr), appWindow(parent), untitledIndex(index),
-      fileWatcher(new QFileSystemWatcher(this)), reloading(false), killingProcesses(false),
+      reloading(false), killingProcesses(false),
       autoSaveTimer(new QTimer(this))
 {
+    TRACE_STARTUP("MainWindow::MainWindow");
     LOG_INFO(INFO_OF(index));
 
     ui->setupUi(this);
@@ -71,10 +82,23 @@ MainWindow::MainWindow(int index, AppWindow *parent)
 
     setEditor();
     setStopwatch();
-    connect(fileWatcher, &QFileSystemWatcher::fileChanged, this, &MainWindow::onFileWatcherChanged);
     connect(
         autoSaveTimer, &QTimer::timeout, autoSaveTimer, [this] { saveFile(AutoSave, tr("Auto Save"), false); },
         Qt::DirectConnection);
+
+    auto emitStatusChanged = [this] { emit statusChanged(this); };
+    connect(testcases, &Widgets::TestCases::statusChanged, this, emitStatusChanged);
+    connect(editor, &Editor::CodeEditor::cursorPositionChanged, this, emitStatusChanged);
+    connect(editor, &Editor::CodeEditor::selectionChanged, this, emitStatusChanged);
+    connect(editor->horizontalScrollBar(), &QScrollBar::valueChanged, this, emitStatusChanged);
+    connect(editor->verticalScrollBar(), &QScrollBar::valueChanged, this, emitStatusChanged);
+    connect(this, &MainWindow::editorFileChanged, this, emitStatusChanged);
+    connect(this, &MainWindow::editorLanguageChanged, this, emitStatusChanged);
+
+    using SettingsHelper::Key;
+    SettingsManager::subscribe(this, {Key::SaveTests, Key::InputFileSavePath, Key::AnswerFileSavePath},
+                               [this] { updateWatcher(); });
+
     applySettings("");
     QTimer::singleShot(0, [this] { editor->resize(0, 0); }); // refresh editor geometry
 }
@@ -104,7 +128,6 @@ MainWindow::~MainWindow()
     delete ui;
     delete autoSaveTimer;
     delete testcases;
-    delete fileWatcher;
     delete editor;
     delete log;
     delete stopwatch;
@@ -181,6 +204,8 @@ void MainWindow::run()
     }
 
     checker->clearTasks();
+    if (interactor != nullptr)
+        interactor->clearTasks();
 
     for (int i = 0; i < testcases->count(); ++i)
     {
@@ -209,9 +234,18 @@ void MainWindow::run(int index)
     connect(tmp, &Core::Runner::failedToStartRun, this, &MainWindow::onFailedToStartRun);
     connect(tmp, &Core::Runner::runOutputLimitExceeded, this, &MainWindow::onRunOutputLimitExceeded);
     connect(tmp, &Core::Runner::runKilled, this, &MainWindow::onRunKilled);
-    tmp->run(tmpPath(), filePath, language, SettingsManager::get(QString("%1/Run Command").arg(language)).toString(),
-             SettingsManager::get(QString("%1/Run Arguments").arg(language)).toString(), testcases->input(index),
-             timeLimit());
+    const auto runCommand = SettingsManager::get(QString("%1/Run Command").arg(language)).toString();
+    const auto runArgs = SettingsManager::get(QString("%1/Run Arguments").arg(language)).toString();
+    if (interactor != nullptr)
+    {
+        interactor->requestInteraction(tmp, tmpPath(), filePath, language, runCommand, runArgs,
+                                       testcases->input(index), testcases->expected(index), timeLimit());
+    }
+    else
+    {
+        tmp->setFileIO(inputFileName, outputFileName);
+        tmp->run(tmpPath(), filePath, language, runCommand, runArgs, testcases->input(index), timeLimit());
+    }
     runner.push_back(tmp);
 }
 
@@ -293,7 +327,12 @@ int MainWindow::getUntitledIndex() const
 
 QString MainWindow::getFileName() const
 {
-    if (!isUntitled())
+    return getFileName(filePath, problemURL, untitledIndex);
+}
+
+QString MainWindow::getFileName(const QString &filePath, const QString &problemURL, int untitledIndex)
+{
+    if (!filePath.isEmpty())
         return QFileInfo(filePath).fileName();
     if (!problemURL.isEmpty())
         return QRegularExpression(R"(.*/([^\?#].*?)/?$)").match(problemURL).captured(1);
@@ -312,24 +351,36 @@ QString MainWindow::getProblemURL() const
 
 QString MainWindow::getCompleteTitle() const
 {
-    if (!isUntitled())
+    return getCompleteTitle(filePath, problemURL, untitledIndex);
+}
+
+QString MainWindow::getCompleteTitle(const QString &filePath, const QString &problemURL, int untitledIndex)
+{
+    if (!filePath.isEmpty())
         return filePath;
     if (!problemURL.isEmpty())
         return problemURL;
 
-    return getFileName();
+    return getFileName(filePath, problemURL, untitledIndex);
 }
 
 QString MainWindow::getTabTitle(bool complete, bool star, int removeLength)
 {
+    return getTabTitle(filePath, problemURL, untitledIndex, complete, star && isTextChanged(), removeLength);
+}
+
+QString MainWindow::getTabTitle(const QString &filePath, const QString &problemURL, int untitledIndex, bool complete,
+                                bool star, int removeLength)
+{
+    const auto fileName = getFileName(filePath, problemURL, untitledIndex);
     QString tabTitle;
-    if (!complete || (isUntitled() && problemURL.isEmpty()))
-        tabTitle = getFileName();
-    else if (!isUntitled())
-        tabTitle = getFileName() + " - " + QFileInfo(filePath).path().remove(0, removeLength);
+    if (!complete || (filePath.isEmpty() && problemURL.isEmpty()))
+        tabTitle = fileName;
+    else if (!filePath.isEmpty())
+        tabTitle = fileName + " - " + QFileInfo(filePath).path().remove(0, removeLength);
     else
-        tabTitle = getFileName() + " - " + getProblemURL().remove(0, removeLength);
-    if (star && isTextChanged())
+        tabTitle = fileName + " - " + QString(problemURL).remove(0, removeLength);
+    if (star)
         tabTitle += " *";
     return tabTitle;
 }
@@ -387,6 +438,7 @@ void MainWindow::setProblemURL(const QString &url)
 void MainWindow::setUntitledIndex(int index)
 {
     untitledIndex = index;
+    emit statusChanged(this);
 }
 
 #define FROMSTATUS(x) x = status.value(#x)
@@ -395,6 +447,7 @@ MainWindow::EditorStatus::EditorStatus(const QMap<QString, QVariant> &status)
 {
     LOG_INFO("Window status from map");
     FROMSTATUS(timestamp).toLongLong();
+    FROMSTATUS(filePending).toBool();
     FROMSTATUS(isLanguageSet).toInt();
     FROMSTATUS(filePath).toString();
     FROMSTATUS(savedText).toString();
@@ -402,6 +455,9 @@ MainWindow::EditorStatus::EditorStatus(const QMap<QString, QVariant> &status)
     FROMSTATUS(editorText).toString();
     FROMSTATUS(language).toString();
     FROMSTATUS(customCompileCommand).toString();
+    FROMSTATUS(interactorPath).toString();
+    FROMSTATUS(inputFileName).toString();
+    FROMSTATUS(outputFileName).toString();
     FROMSTATUS(editorCursor).toInt();
     FROMSTATUS(editorAnchor).toInt();
     FROMSTATUS(horizontalScrollBarValue).toInt();
@@ -423,6 +479,7 @@ QMap<QString, QVariant> MainWindow::EditorStatus::toMap() const
     LOG_INFO("Window status to hashmap");
     QMap<QString, QVariant> status;
     TOSTATUS(timestamp);
+    TOSTATUS(filePending);
     TOSTATUS(isLanguageSet);
     TOSTATUS(filePath);
     TOSTATUS(savedText);
@@ -430,6 +487,9 @@ QMap<QString, QVariant> MainWindow::EditorStatus::toMap() const
     TOSTATUS(editorText);
     TOSTATUS(language);
     TOSTATUS(customCompileCommand);
+    TOSTATUS(interactorPath);
+    TOSTATUS(inputFileName);
+    TOSTATUS(outputFileName);
     TOSTATUS(editorCursor);
     TOSTATUS(editorAnchor);
     TOSTATUS(horizontalScrollBarValue);
@@ -459,6 +519,9 @@ MainWindow::EditorStatus MainWindow::toStatus() const
     status.editorText = editor->toPlainText();
     status.language = language;
     status.customCompileCommand = customCompileCommand;
+    status.interactorPath = interactorPath;
+    status.inputFileName = inputFileName;
+    status.outputFileName = outputFileName;
     status.editorCursor = editor->textCursor().position();
     status.editorAnchor = editor->textCursor().anchor();
     status.horizontalScrollBarValue = editor->horizontalScrollBar()->value();
@@ -478,6 +541,7 @@ MainWindow::EditorStatus MainWindow::toStatus() const
 
 void MainWindow::loadStatus(const EditorStatus &status, bool duplicate)
 {
+    TRACE_STARTUP("MainWindow::loadStatus", status.filePath);
     LOG_INFO("Requesting loadStatus");
     setProblemURL(status.problemURL);
     if (status.isLanguageSet)
@@ -492,6 +556,7 @@ void MainWindow::loadStatus(const EditorStatus &status, bool duplicate)
     testcases->setCheckerIndex(status.checkerIndex);
     savedText = status.savedText;
     editor->setPlainText(status.editorText);
+    reloadDiskText();
     auto cursor = editor->textCursor();
     cursor.setPosition(status.editorAnchor);
     cursor.setPosition(status.editorCursor, QTextCursor::KeepAnchor);
@@ -499,6 +564,10 @@ void MainWindow::loadStatus(const EditorStatus &status, bool duplicate)
     editor->horizontalScrollBar()->setValue(status.horizontalScrollBarValue);
     editor->verticalScrollBar()->setValue(status.verticalScrollbarValue);
     customTimeLimit = status.customTimeLimit;
+    interactorPath = status.interactorPath;
+    resetInteractor();
+    inputFileName = status.inputFileName;
+    outputFileName = status.outputFileName;
     testcases->loadStatus(status.input, status.expected);
     for (int i = 0; i < status.testcasesIsShow.count() && i < testcases->count(); ++i)
         testcases->setChecked(i, status.testcasesIsShow[i].toBool());
@@ -513,13 +582,13 @@ void MainWindow::loadStatus(const EditorStatus &status, bool duplicate)
             if (mTime.isValid() && mTime.toMSecsSinceEpoch() > status.timestamp)
             {
                 if (appWindow->isInitialized())
-                    onFileWatcherChanged(filePath);
+                    onFileWatcherChanged(filePath, Util::readFile(filePath));
                 else
                 {
                     // Change this to Qt::SingleShotConnection after migrating to Qt 6
                     auto *connection = new QMetaObject::Connection;
                     *connection = connect(appWindow, &AppWindow::initialized, [this, connection] {
-                        onFileWatcherChanged(filePath);
+                        onFileWatcherChanged(filePath, Util::readFile(filePath));
                         disconnect(*connection);
                         delete connection;
                     });
@@ -549,7 +618,7 @@ void MainWindow::applyCompanion(const Extensions::CompanionData &data)
             auto match = it.next();
             finalComments += comments.mid(lastEnd, match.capturedStart() - lastEnd);
             auto path = match.captured().mid(7, match.capturedLength() - 8).split(".");
-            auto value = QJsonValue::fromVariant(data.doc.toVariant());
+            QJsonValue value = data.doc.object();
             for (auto const &attr : path)
                 value = value[attr];
             if (value.isUndefined())
@@ -603,6 +672,22 @@ void MainWindow::applyCompanion(const Extensions::CompanionData &data)
 
     if (SettingsHelper::isCompetitiveCompanionSetTimeLimitForTab())
         customTimeLimit = data.timeLimit;
+
+    // e.g. {"type": "file", "fileName": "input.txt"}, the other types are stdin, stdout and regex
+    auto fileIOName = [this, &data](const QString &key) {
+        const auto io = data.doc.object().value(key).toObject();
+        if (io.value("type").toString() != "file")
+            return QString();
+        const auto name = io.value("fileName").toString();
+        if (Util::isPlainFileName(name))
+            return name;
+        log->warn(tr("Companion"), tr("Ignored the invalid file name [%1], using standard I/O instead").arg(name));
+        return QString();
+    };
+    inputFileName = fileIOName("input");
+    outputFileName = fileIOName("output");
+
+    emit statusChanged(this);
 }
 
 void MainWindow::applySettings(const QString &pagePath)
@@ -643,8 +728,7 @@ void MainWindow::applySettings(const QString &pagePath)
         }
     }
 
-    if (pageChanged("Code Edit") || pagePath.startsWith("Appearance/") ||
-        pageChanged(QString("Language/%1/%1 Parentheses").arg(language)))
+    if (pagePath.isEmpty()) // otherwise the editor re-applies only the settings it uses, see CodeEditor::CodeEditor()
         editor->applySettings(language);
 
     if (!isLanguageSet && pageChanged("Language/General"))
@@ -652,6 +736,9 @@ void MainWindow::applySettings(const QString &pagePath)
         setLanguage(SettingsHelper::getDefaultLanguage());
     }
 
+    if (isUntitled() && pageChanged(QString("Language/%1/%1 Template").arg(language)))
+        reloadDiskText();
+
     if (pageChanged("Appearance/General"))
     {
         testcases->updateHeights();
@@ -742,13 +829,18 @@ void MainWindow::compileAndRun()
     compile();
 }
 
-void MainWindow::formatSource(bool selectionOnly, bool logOnNoChange)
+void MainWindow::formatSource(bool selectionOnly, bool logOnNoChange, bool wait)
 {
-    LOG_INFO("Requested code format");
+    LOG_INFO("Requested code format" << BOOL_INFO_OF(wait));
+
+    // the result of the previous request would be discarded anyway, because the code is changed by this request
+    delete formatter;
+
     if (language == "Python")
-        Extensions::YAPFormatter(editor, language, selectionOnly, logOnNoChange, log, this).format();
+        formatter = new Extensions::YAPFormatter(editor, language, selectionOnly, logOnNoChange, log, this);
     else
-        Extensions::ClangFormatter(editor, language, selectionOnly, logOnNoChange, log, this).format();
+        formatter = new Extensions::ClangFormatter(editor, language, selectionOnly, logOnNoChange, log, this);
+    formatter->format(wait);
 }
 
 void MainWindow::setLanguage(const QString &lang)
@@ -759,6 +851,7 @@ void MainWindow::setLanguage(const QString &lang)
         LOG_INFO("Language not changed");
         return;
     }
+    bool templateLoaded = false;
     if (!QFile::exists(filePath))
     {
         QString templateContent;
@@ -769,11 +862,14 @@ void MainWindow::setLanguage(const QString &lang)
         {
             language = lang;
             loadFile(filePath);
+            templateLoaded = true;
         }
     }
     language = lang;
     if (language != "Python" && language != "Java")
         language = "C++";
+    if (isUntitled() && !templateLoaded)
+        reloadDiskText(); // an untitled tab is compared with the template of its language
     editor->applySettings(language);
     customCompileCommand.clear();
     ui->changeLanguageButton->setText(language);
@@ -877,16 +973,56 @@ void MainWindow::setText(const QString &text, bool keep)
 
 void MainWindow::updateWatcher()
 {
-    if (fileWatcher->files() == QStringList(filePath))
+    testcases->setWatchedFilePath(isUntitled() || !SettingsHelper::isSaveTests() ? QString() : filePath);
+
+    if (watchedFilePath == filePath)
         return;
-    if (!fileWatcher->files().isEmpty())
-        fileWatcher->removePaths(fileWatcher->files());
+    if (!watchedFilePath.isEmpty())
+        Core::FileWatcher::instance()->unwatch(this, watchedFilePath);
+    watchedFilePath = filePath;
     if (!isUntitled())
-        fileWatcher->addPath(filePath);
+    {
+        Core::FileWatcher::instance()->watch(this, filePath, [this](const QString &path, const QString &content) {
+            onFileWatcherChanged(path, content);
+        });
+    }
+}
+
+void MainWindow::setDiskText(const QString &text)
+{
+    if (text.isNull())
+    {
+        diskTextHash.clear();
+        diskTextLength = -1;
+    }
+    else
+    {
+        diskTextHash = textHash(text);
+        diskTextLength = text.length();
+    }
+
+    // Compare with the editor text once, then let the modification flag of the document, which follows the
+    // clean state of the undo stack, tell isTextChanged() whether it has to compare again.
+    textChangedCacheValid = false;
+    editor->document()->setModified(true);
+    editor->document()->setModified(isTextChanged());
+
+    emit editorTextChanged(this);
+    emit statusChanged(this); // savedText may be changed
+}
+
+void MainWindow::reloadDiskText()
+{
+    if (isUntitled())
+        setDiskText(Util::readFile(SettingsManager::get(QString("%1/Template Path").arg(language)).toString(),
+                                   tr("Read %1 Template").arg(language), log));
+    else
+        setDiskText(Util::readFile(filePath));
 }
 
 void MainWindow::loadFile(const QString &loadPath)
 {
+    TRACE_STARTUP("MainWindow::loadFile", loadPath);
     LOG_INFO(INFO_OF(loadPath));
 
     auto path = loadPath;
@@ -910,6 +1046,7 @@ void MainWindow::loadFile(const QString &loadPath)
         else
         {
             setText("");
+            setDiskText(QString());
             return;
         }
     }
@@ -917,7 +1054,10 @@ void MainWindow::loadFile(const QString &loadPath)
     auto content = Util::readFile(path, tr("Open File"), log);
 
     if (content.isNull())
+    {
+        setDiskText(QString());
         return;
+    }
 
     savedText = content;
     if (content.length() > SettingsHelper::getOpenFileLengthLimit())
@@ -931,6 +1071,7 @@ void MainWindow::loadFile(const QString &loadPath)
                    false);
         setText("");
         setFilePath("");
+        reloadDiskText();
         return;
     }
 
@@ -938,6 +1079,7 @@ void MainWindow::loadFile(const QString &loadPath)
         setProblemURL(FileProblemBinder::getProblemForFile(filePath));
 
     setText(content, samePath);
+    setDiskText(isTemplate && !isUntitled() ? QString() : content);
 
     if (isTemplate)
     {
@@ -971,7 +1113,7 @@ bool MainWindow::saveFile(SaveMode mode, const QString &head, bool safe)
     if ((mode != AutoSave && SettingsHelper::isFormatOnManualSave()) ||
         (mode == AutoSave && SettingsHelper::isFormatOnAutoSave()))
     {
-        formatSource(false, false);
+        formatSource(false, false, true); // the formatted code is saved
     }
 
     if (mode == SaveAs || (isUntitled() && mode == AlwaysSave))
@@ -1041,6 +1183,7 @@ bool MainWindow::saveFile(SaveMode mode, const QString &head, bool safe)
             return beforeReturn(false);
 
         savedText = editor->toPlainText();
+        setDiskText(savedText);
 
         setFilePath(newFilePath);
 
@@ -1064,6 +1207,7 @@ bool MainWindow::saveFile(SaveMode mode, const QString &head, bool safe)
             return false;
 
         savedText = editor->toPlainText();
+        setDiskText(savedText);
     }
     else
     {
@@ -1107,7 +1251,7 @@ QString MainWindow::tmpPath()
         return "";
     }
     QString path = tmpDir->filePath(name);
-    if (!Util::saveFile(path, editor->toPlainText(), tr("Temp File"), false, log))
+    if (!Util::saveFile(path, editor->toPlainText(), tr("Temp File"), false, log, false, Util::FileKind::Temp))
         return QString();
     if (created && isUntitled())
         emit requestUpdateLanguageServerFilePath(this, path);
@@ -1126,7 +1270,10 @@ void MainWindow::updateCompileCommand()
         QInputDialog::getText(this, tr("Set Compile Command"), tr("Custom compile command for this tab:"),
                               QLineEdit::Normal, compileCommand(), &ok);
     if (ok)
+    {
         customCompileCommand = command;
+        emit statusChanged(this);
+    }
 }
 
 void MainWindow::updateTimeLimit()
@@ -1135,25 +1282,79 @@ void MainWindow::updateTimeLimit()
     const int limit = QInputDialog::getInt(this, tr("Set Time Limit"), tr("Custom time limit for this tab: (ms)"),
                                            timeLimit(), 1, 3600000, 1000, &ok);
     if (ok)
+    {
         customTimeLimit = limit;
+        emit statusChanged(this);
+    }
 }
 
-bool MainWindow::isTextChanged() const
+void MainWindow::updateInteractor()
 {
-    if (isUntitled())
+    const auto path =
+        QFileInfo(DefaultPathManager::getOpenFileName("Interactor", this, tr("Set Interactor"))).canonicalFilePath();
+    if (!path.isEmpty())
+        setInteractorPath(path);
+}
+
+void MainWindow::setInteractorPath(const QString &path)
+{
+    interactorPath = path;
+    resetInteractor();
+    emit statusChanged(this);
+}
+
+QString MainWindow::getInteractorPath() const
+{
+    return interactorPath;
+}
+
+void MainWindow::updateFileIO()
+{
+    bool ok = false;
+    const auto current = QString("%1 %2")
+                             .arg(inputFileName.isEmpty() ? "-" : inputFileName)
+                             .arg(outputFileName.isEmpty() ? "-" : outputFileName);
+    const auto names = QInputDialog::getText(this, tr("Set File I/O"),
+                                             tr("Input and output file names for this tab, separated by a space.\n"
+                                                "Use \"-\" for standard input or output:"),
+                                             QLineEdit::Normal, current, &ok)
+                           .split(' ', Qt::SkipEmptyParts);
+    if (ok)
     {
-        auto content = Util::readFile(SettingsManager::get(QString("%1/Template Path").arg(language)).toString(),
-                                      tr("Read %1 Template").arg(language), log);
-        if (content.isNull())
-            return !editor->toPlainText().isEmpty();
-        return editor->toPlainText() != content;
+        const auto input = names.value(0) == "-" ? QString() : names.value(0);
+        const auto output = names.value(1) == "-" ? QString() : names.value(1);
+        auto isValid = [](const QString &name) { return name.isEmpty() || Util::isPlainFileName(name); };
+        if (!isValid(input) || !isValid(output))
+        {
+            log->warn(tr("File I/O"),
+                      tr("The file names can't be absolute or contain \"/\", \"\\\", \":\" or \"..\""));
+            return;
+        }
+        inputFileName = input;
+        outputFileName = output;
+        emit statusChanged(this);
     }
-    auto content = Util::readFile(filePath);
+}
 
-    if (content.isNull())
-        return true;
+bool MainWindow::isTextChanged() const
+{
+    auto *document = editor->document();
+
+    if (diskTextHash.isNull())
+        return isUntitled() ? !document->isEmpty() : true;
+
+    if (!document->isModified())
+        return false;
+
+    if (!textChangedCacheValid)
+    {
+        // characterCount() includes the last paragraph separator
+        textChangedCache =
+            document->characterCount() - 1 != diskTextLength || textHash(editor->toPlainText()) != diskTextHash;
+        textChangedCacheValid = true;
+    }
 
-    return editor->toPlainText() != content;
+    return textChangedCache;
 }
 
 bool MainWindow::closeConfirm()
@@ -1201,15 +1402,13 @@ void MainWindow::on_changeLanguageButton_clicked()
         setLanguage(response);
 }
 
-void MainWindow::onFileWatcherChanged(const QString &path)
+void MainWindow::onFileWatcherChanged(const QString &path, const QString &fileText)
 {
     LOG_INFO(INFO_OF(path));
 
-    emit editorTextChanged(this);
-
     auto currentText = editor->toPlainText();
 
-    auto fileText = Util::readFile(path);
+    setDiskText(fileText); // this also updates the tab title
 
     if (!fileText.isNull())
     {
@@ -1249,12 +1448,14 @@ void MainWindow::onFileWatcherChanged(const QString &path)
 
 void MainWindow::onTextChanged()
 {
+    textChangedCacheValid = false;
     if (SettingsHelper::isAutoSave() && SettingsHelper::getAutoSaveIntervalType() != "Without modification" &&
         (!autoSaveTimer->isActive() || SettingsHelper::getAutoSaveIntervalType() == "After the last modification"))
     {
         autoSaveTimer->start();
     }
     emit editorTextChanged(this);
+    emit statusChanged(this);
 }
 
 void MainWindow::updateCursorInfo()
@@ -1304,6 +1505,17 @@ void MainWindow::updateChecker()
     checker->prepare();
 }
 
+void MainWindow::resetInteractor()
+{
+    delete interactor;
+    interactor = nullptr;
+    if (interactorPath.isEmpty())
+        return;
+    interactor = new Core::Checker(interactorPath, log, this);
+    connect(interactor, &Core::Checker::checkFinished, testcases, &Widgets::TestCases::setVerdict);
+    interactor->prepare();
+}
+
 QSplitter *MainWindow::getSplitter()
 {
     return ui->splitter;
@@ -1464,7 +1676,15 @@ QString MainWindow::getRunnerHead(int index)
 
 void MainWindow::onRunStarted(int index)
 {
-    log->info(getRunnerHead(index), tr("Execution has started"));
+    if (index == -1)
+    {
+        log->info(getRunnerHead(index), tr("Execution has started"));
+        return;
+    }
+    log->groupedInfo("Run Started", getRunnerHead(index), tr("Execution has started"), 0,
+                     [](int count, qint64 /*unused*/, qint64 /*unused*/) {
+                         return tr("Execution of %n test case(s) has started", "", count);
+                     });
 }
 
 void MainWindow::onRunFinished(int index, const QString &out, const QString &err, int exitCode, qint64 timeUsed,
@@ -1474,10 +1694,20 @@ void MainWindow::onRunFinished(int index, const QString &out, const QString &err
 
     if (exitCode == 0)
     {
-        log->info(head, tr("Execution for test case #%1 has finished in %2ms").arg(index + 1).arg(timeUsed));
-
-        if ((!out.isEmpty() && !testcases->expected(index).isEmpty()) ||
-            (SettingsHelper::isCheckOnTestcasesWithEmptyOutput() && exitCode == 0))
+        log->groupedInfo("Run Finished", head,
+                         tr("Execution for test case #%1 has finished in %2ms").arg(index + 1).arg(timeUsed), timeUsed,
+                         [](int count, qint64 minTime, qint64 maxTime) {
+                             if (minTime == maxTime)
+                                 return tr("Execution for %n test case(s) has finished in %1ms", "", count)
+                                     .arg(minTime);
+                             return tr("Execution for %n test case(s) has finished in %1~%2ms", "", count)
+                                 .arg(minTime)
+                                 .arg(maxTime);
+                         });
+
+        // the verdict of an interactive execution is given by the interactor
+        if (interactor == nullptr && ((!out.isEmpty() && !testcases->expected(index).isEmpty()) ||
+                                      (SettingsHelper::isCheckOnTestcasesWithEmptyOutput() && exitCode == 0)))
             checker->reqeustCheck(index, testcases->input(index), out, testcases->expected(index));
     }
 
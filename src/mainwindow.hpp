@@ -19,6 +19,7 @@
 #define MAINWINDOW_HPP
 
 #include <QMainWindow>
+#include <QPointer>
 
 class AppWindow;
 class MessageLogger;
@@ -26,7 +27,6 @@ namespace Editor
 {
 class CodeEditor;
 }
-class QFileSystemWatcher;
 class QPushButton;
 class QSplitter;
 class QTemporaryDir;
@@ -47,6 +47,7 @@ class Runner;
 namespace Extensions
 {
 class CFTool;
+class CodeFormatter;
 struct CompanionData;
 } // namespace Extensions
 
@@ -65,8 +66,10 @@ class MainWindow : public QMainWindow
     {
         qint64 timestamp = 0; // MSecsSinceEpoch when the status was recorded
 
+        bool filePending{}; // whether the file is not read yet, then the texts are empty and it's opened when loaded
         bool isLanguageSet{};
-        QString filePath, savedText, problemURL, editorText, language, customCompileCommand;
+        QString filePath, savedText, problemURL, editorText, language, customCompileCommand, interactorPath,
+            inputFileName, outputFileName;
         int editorCursor{}, editorAnchor{}, horizontalScrollBarValue{}, verticalScrollbarValue{}, untitledIndex{},
             checkerIndex{}, customTimeLimit{};
         QStringList input, expected, customCheckers;
@@ -91,6 +94,16 @@ class MainWindow : public QMainWindow
     QString getProblemURL() const;
     QString getCompleteTitle() const;
     QString getTabTitle(bool complete, bool star, int removeLength = 0);
+
+    /**
+     * @brief the titles of a tab with the given file path, problem URL and untitled index
+     * @note These are also used for the tabs that are not loaded yet, where there's no MainWindow.
+     */
+    static QString getFileName(const QString &filePath, const QString &problemURL, int untitledIndex);
+    static QString getCompleteTitle(const QString &filePath, const QString &problemURL, int untitledIndex);
+    static QString getTabTitle(const QString &filePath, const QString &problemURL, int untitledIndex, bool complete,
+                               bool star, int removeLength);
+
     Editor::CodeEditor *getEditor() const;
     bool isUntitled() const;
 
@@ -111,7 +124,11 @@ class MainWindow : public QMainWindow
     void compileOnly();
     void runOnly();
     void compileAndRun();
-    void formatSource(bool selectionOnly, bool logOnNoChange);
+    /**
+     * @brief format the code in the editor
+     * @param wait whether to wait until the formatted code is applied, otherwise it's applied asynchronously
+     */
+    void formatSource(bool selectionOnly, bool logOnNoChange, bool wait = false);
 
     void applyCompanion(const Extensions::CompanionData &data);
 
@@ -143,6 +160,24 @@ class MainWindow : public QMainWindow
      */
     void updateTimeLimit();
 
+    /**
+     * @brief ask the user for the testlib interactor of this tab
+     */
+    void updateInteractor();
+
+    /**
+     * @brief set the testlib interactor of this tab
+     * @param path the path to the source file of the interactor, empty to run the program normally
+     */
+    void setInteractorPath(const QString &path);
+
+    QString getInteractorPath() const;
+
+    /**
+     * @brief ask the user for the input and output file names of this tab
+     */
+    void updateFileIO();
+
   private slots:
     void onCompilationStarted();
     void onCompilationFinished(const QString &warning);
@@ -156,7 +191,6 @@ class MainWindow : public QMainWindow
     void onRunOutputLimitExceeded(int index, const QString &type);
     void onRunKilled(int index);
 
-    void onFileWatcherChanged(const QString &);
     void onTextChanged();
     void updateCursorInfo();
     void updateChecker();
@@ -182,6 +216,7 @@ class MainWindow : public QMainWindow
     void editorLanguageChanged(MainWindow *window);
     void compileOrRunTriggered();
     void fileSaved(MainWindow *window);
+    void statusChanged(MainWindow *window); // anything in toStatus() may be changed
 
   private:
     enum SaveMode
@@ -206,6 +241,7 @@ class MainWindow : public QMainWindow
     Core::Compiler *compiler = nullptr;
     QVector<Core::Runner *> runner;
     Core::Checker *checker = nullptr;
+    Core::Checker *interactor = nullptr; // the interactor of interactive problems, null if there's none
     Core::Runner *detachedRunner = nullptr;
     QTemporaryDir *tmpDir = nullptr;
     AfterCompile afterCompile = Nothing;
@@ -218,8 +254,12 @@ class MainWindow : public QMainWindow
     QString problemURL;
     QString filePath;
     QString savedText;
+    QByteArray diskTextHash;                    // hash of the text isTextChanged() compares with, null if unreadable
+    int diskTextLength = -1;                    // length of the text isTextChanged() compares with
+    mutable bool textChangedCacheValid = false; // whether textChangedCache is up to date with the editor text
+    mutable bool textChangedCache = false;      // the cached result of isTextChanged()
     QString cftoolPath;
-    QFileSystemWatcher *fileWatcher;
+    QString watchedFilePath; // the file watched by Core::FileWatcher, empty if nothing is watched
 
     std::atomic<bool> reloading;
     std::atomic<bool> killingProcesses;
@@ -232,13 +272,19 @@ class MainWindow : public QMainWindow
 
     QTimer *autoSaveTimer = nullptr;
 
+    QPointer<Extensions::CodeFormatter> formatter; // the running formatter, null if there's none
+
     int customTimeLimit = -1;     // the custom time limit for this tab, -1 represents for the same as settings
     QString customCompileCommand; // the custom compile command for this tab, empty represents for the same as settings
+    QString interactorPath;       // the testlib interactor for this tab, empty represents for a non-interactive problem
+    QString inputFileName;        // the input file the program reads in this tab, empty represents for stdin only
+    QString outputFileName;       // the output file the program writes in this tab, empty represents for stdout only
 
     void setEditor();
     void compile();
     void run();
     void run(int index);
+    void resetInteractor();
     void loadTests();
     void saveTests(bool safe);
     void setCFToolUI();
@@ -246,6 +292,24 @@ class MainWindow : public QMainWindow
     void setFilePath(QString path, bool updateBinder = true);
     void setText(const QString &text, bool keep = false);
     void updateWatcher();
+
+    /**
+     * @brief handle the changes of the file on the disk
+     * @param fileText the new content of the file, a null QString if it's removed or can't be read
+     */
+    void onFileWatcherChanged(const QString &path, const QString &fileText);
+
+    /**
+     * @brief set the text on the disk which the editor text is compared with in isTextChanged()
+     * @param text the content of the file, or the template for an untitled tab, null if it can't be read
+     */
+    void setDiskText(const QString &text);
+
+    /**
+     * @brief re-read the file, or the template for an untitled tab, and pass it to setDiskText()
+     */
+    void reloadDiskText();
+
     void loadFile(const QString &loadPath);
     bool saveFile(SaveMode mode, const QString &head, bool safe);
     void performCompileAndRunDiagonistics();